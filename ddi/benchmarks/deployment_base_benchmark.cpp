@@ -0,0 +1,169 @@
+// deploymentBase parsing: SAX reader of DeploymentBase_::from against the DOM parser it replaced.
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "actions_impl.hpp"
+#include "ddi/hawkbit_exceptions.hpp"
+#include "json_arena.hpp"
+#include "rapidjson/document.h"
+#include "utils.hpp"
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    const int ITERATIONS = 2000;
+
+    struct DomArtifact {
+        std::string filename;
+        int fileSize;
+        uri::URI downloadURI;
+        ddi::Hashes fileHash;
+    };
+
+    struct DomChunk {
+        std::string part;
+        std::string version;
+        std::string name;
+        std::vector<std::shared_ptr<DomArtifact>> artifacts;
+    };
+
+    struct DomDeploymentBase {
+        int id;
+        std::string downloadType;
+        std::string updateType;
+        bool inMaintenanceWindow;
+        std::vector<std::shared_ptr<DomChunk>> chunks;
+    };
+
+    // parser before SAX reader: Document is built, every member is looked up by name
+    std::unique_ptr<DomDeploymentBase> parseDom(const std::string &body) {
+        rapidjson::Document document;
+        document.Parse<0>(body.c_str());
+
+        if (document.HasParseError())
+            throw ddi::unexpected_payload();
+
+        if (!document.HasMember("id") || !document.HasMember("deployment") ||
+            !document["deployment"].HasMember("update") || !document["deployment"].HasMember("download")
+            || !document["deployment"].HasMember("chunks")) {
+            throw ddi::unexpected_payload();
+        }
+
+        auto deploymentBase = std::unique_ptr<DomDeploymentBase>(new DomDeploymentBase());
+        deploymentBase->id = std::stoi(document["id"].GetString());
+        deploymentBase->updateType = document["deployment"]["update"].GetString();
+        deploymentBase->downloadType = document["deployment"]["download"].GetString();
+
+        if (document["deployment"].HasMember("maintenanceWindow")) {
+            std::string window = document["deployment"]["maintenanceWindow"].GetString();
+            deploymentBase->inMaintenanceWindow = window != "unavailable";
+        } else {
+            deploymentBase->inMaintenanceWindow = true;
+        }
+
+        const rapidjson::Value &chunks_ = document["deployment"]["chunks"];
+        for (rapidjson::Value::ConstValueIterator itr = chunks_.Begin(); itr != chunks_.End(); ++itr) {
+            const rapidjson::Value &chunk = *itr;
+            if (!chunk.HasMember("part") || !chunk.HasMember("version") || !chunk.HasMember("name")
+                || !chunk.HasMember("artifacts")) {
+                throw ddi::unexpected_payload();
+            }
+
+            auto chunkPtr = std::make_shared<DomChunk>();
+            chunkPtr->name = chunk["name"].GetString();
+            chunkPtr->version = chunk["version"].GetString();
+            chunkPtr->part = chunk["part"].GetString();
+
+            const rapidjson::Value &artifacts_ = chunk["artifacts"];
+            for (rapidjson::Value::ConstValueIterator itr_a = artifacts_.Begin(); itr_a != artifacts_.End(); ++itr_a) {
+                const rapidjson::Value &artifact = *itr_a;
+                if (!artifact.HasMember("filename") || !artifact.HasMember("hashes") || !artifact.HasMember("size")
+                    || !artifact.HasMember("_links") || !artifact["hashes"].HasMember("sha256")
+                    || !artifact["hashes"].HasMember("sha1") || !artifact["hashes"].HasMember("md5")
+                    || !artifact["_links"].HasMember("download-http")
+                    || !artifact["_links"]["download-http"].HasMember("href")) {
+                    throw ddi::unexpected_payload();
+                }
+                auto artifactPtr = std::make_shared<DomArtifact>();
+                artifactPtr->filename = artifact["filename"].GetString();
+                artifactPtr->fileSize = artifact["size"].GetInt();
+                const rapidjson::Value &href = artifact["_links"]["download-http"]["href"];
+                artifactPtr->downloadURI = ddi::parseHref(href.GetString(), href.GetStringLength());
+                artifactPtr->fileHash.md5 = artifact["hashes"]["md5"].GetString();
+                artifactPtr->fileHash.sha1 = artifact["hashes"]["sha1"].GetString();
+                artifactPtr->fileHash.sha256 = artifact["hashes"]["sha256"].GetString();
+
+                chunkPtr->artifacts.push_back(artifactPtr);
+            }
+
+            deploymentBase->chunks.push_back(chunkPtr);
+        }
+        return deploymentBase;
+    }
+
+    std::string deploymentBase(int chunks, int artifactsPerChunk) {
+        std::string body = R"({"id":"8","deployment":{"download":"forced","update":"attempt",)"
+                           R"("maintenanceWindow":"available","chunks":[)";
+        for (int c = 0; c < chunks; c++) {
+            if (c > 0) {
+                body += ",";
+            }
+            auto part = std::to_string(c);
+            body += R"({"part":"os","version":"1.)" + part + R"(","name":"module-)" + part
+                    + R"(","metadata":[{"key":"installer","value":"swupdate"}],"artifacts":[)";
+            for (int a = 0; a < artifactsPerChunk; a++) {
+                if (a > 0) {
+                    body += ",";
+                }
+                auto file = "artifact-" + part + "-" + std::to_string(a) + ".bin";
+                auto href = "https://hawkbit.example.com/default/controller/v1/dev-01/softwaremodules/" + part
+                            + "/artifacts/" + file;
+                body += R"({"filename":")" + file + R"(","hashes":{)"
+                        + R"("sha1":"2d86c2a659e364e9abba49ea6ffcd53dd5559f05",)"
+                        + R"("md5":"0d1b08c34858921bc7c662b228acb7ba",)"
+                        + R"("sha256":"a03b221c6c6eae7122ca51695d456d5222e524889136394944b2f9763b483615"},)"
+                        + R"("size":)" + std::to_string(65536 + a) + R"(,"_links":{)"
+                        + R"("download":{"href":")" + href + R"("},)"
+                        + R"("download-http":{"href":")" + href + R"("},)"
+                        + R"("md5sum-http":{"href":")" + href + R"(.MD5SUM"}}})";
+            }
+            body += "]}";
+        }
+        body += R"(]},"actionHistory":{"status":"RUNNING","messages":["download started"]}})";
+        return body;
+    }
+
+    template<typename Parse>
+    double usPerParse(Parse parse) {
+        // warm up allocator and caches
+        parse();
+        auto begin = Clock::now();
+        for (int i = 0; i < ITERATIONS; i++) {
+            parse();
+        }
+        auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - begin);
+        return (double) elapsed.count() / 1000.0 / ITERATIONS;
+    }
+}
+
+int main() {
+    ddi::JsonArena arena;
+    for (int chunks: {1, 10}) {
+        const int artifactsPerChunk = 50;
+        auto body = deploymentBase(chunks, artifactsPerChunk);
+
+        // reset before every parse as the client does before every poll
+        auto sax = usPerParse([&]() {
+            arena.reset();
+            ddi::DeploymentBase_::from(body, nullptr, arena);
+        });
+        auto dom = usPerParse([&]() { parseDom(body); });
+
+        std::cout << "artifacts=" << chunks * artifactsPerChunk << " bytes=" << body.size()
+                  << " sax=" << sax << "us dom=" << dom << "us" << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,162 @@
+// Gateway poll scheduling: hierarchical timer wheel against the deadline heap it replaced.
+//  Time is simulated, so the run measures only scheduling and expiry cost, not sleeping.
+#include <chrono>
+#include <cstdlib>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <queue>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "timer_wheel.hpp"
+
+namespace {
+    using ddi::TimerWheel;
+    using Clock = TimerWheel::Clock;
+
+    // controllers poll every 30 s - 5 min, every 10th poll asks to poll again immediately
+    const int MIN_SLEEP_MS = 30 * 1000;
+    const int MAX_SLEEP_MS = 5 * 60 * 1000;
+    const int REPOLL_EVERY = 10;
+    const auto SIMULATED_TIME = std::chrono::minutes(10);
+    // gateway was suspended (or all workers were busy) this long
+    const auto STALL_TIME = std::chrono::hours(24);
+    const auto STEP = std::chrono::milliseconds(ddi::DEFAULT_TIMER_WHEEL_TICK);
+    const std::string CONTROLLER_PREFIX = "controller-";
+
+    struct ScheduledPoll {
+        Clock::time_point deadline;
+        std::string controllerId;
+        unsigned long generation;
+
+        bool operator>(const ScheduledPoll &other) const {
+            return deadline > other.deadline;
+        }
+    };
+
+    using DeadlineHeap = std::priority_queue<ScheduledPoll, std::vector<ScheduledPoll>, std::greater<ScheduledPoll>>;
+
+    struct Result {
+        double scheduleNs;
+        double pollNs;
+        unsigned long polls;
+    };
+
+    double nsPerOperation(Clock::duration elapsed, unsigned long operations) {
+        return (double) std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count() / (double) operations;
+    }
+
+    std::vector<std::string> controllerIds(int controllers) {
+        std::vector<std::string> ids;
+        for (int i = 0; i < controllers; i++) {
+            ids.push_back(CONTROLLER_PREFIX + std::to_string(i));
+        }
+        return ids;
+    }
+
+    // same scheduling as GatewayImpl: re-arm bumps generation, outdated timers are skipped on expiry
+    template<typename Schedule, typename Expire>
+    Result simulate(const std::vector<std::string> &ids, Clock::time_point start, Schedule schedule, Expire expire) {
+        std::mt19937 random(20201);
+        std::uniform_int_distribution<int> sleepTime(MIN_SLEEP_MS, MAX_SLEEP_MS);
+        std::vector<unsigned long> generations(ids.size(), 0);
+        // stands for controllers.find() of the gateway
+        auto indexOf = [](const std::string &id) {
+            return (size_t) std::atol(id.c_str() + CONTROLLER_PREFIX.size());
+        };
+
+        auto begin = Clock::now();
+        for (size_t i = 0; i < ids.size(); i++) {
+            schedule(start + std::chrono::milliseconds(sleepTime(random)), ids[i], ++generations[i]);
+        }
+        auto scheduled = Clock::now() - begin;
+
+        unsigned long polls = 0;
+        std::vector<std::pair<std::string, unsigned long>> due;
+        begin = Clock::now();
+        for (auto now = start; now < start + SIMULATED_TIME; now += STEP) {
+            due.clear();
+            expire(now, due);
+            for (auto &poll: due) {
+                auto index = indexOf(poll.first);
+                if (generations[index] != poll.second) {
+                    continue;
+                }
+                polls++;
+                auto deadline = polls % REPOLL_EVERY == 0 ? now : now + std::chrono::milliseconds(sleepTime(random));
+                schedule(deadline, ids[index], ++generations[index]);
+            }
+        }
+        auto polled = Clock::now() - begin;
+
+        return {nsPerOperation(scheduled, ids.size()), nsPerOperation(polled, polls), polls};
+    }
+
+    Result timerWheel(const std::vector<std::string> &ids) {
+        auto start = Clock::now();
+        TimerWheel wheel(STEP, start);
+        std::deque<TimerWheel::Timer> expired;
+        return simulate(ids, start,
+                        [&](Clock::time_point deadline, const std::string &id, unsigned long generation) {
+                            wheel.schedule(deadline, {id, generation});
+                        },
+                        [&](Clock::time_point now, std::vector<std::pair<std::string, unsigned long>> &due) {
+                            wheel.advance(now, expired);
+                            for (auto &timer: expired) {
+                                due.emplace_back(std::move(timer.key), timer.generation);
+                            }
+                            expired.clear();
+                        });
+    }
+
+    // time to expire all timers after a stall (wheel catches up all ticks of the stall)
+    double stallUs(const std::vector<std::string> &ids) {
+        std::mt19937 random(20201);
+        std::uniform_int_distribution<int> sleepTime(MIN_SLEEP_MS, MAX_SLEEP_MS);
+        auto start = Clock::now();
+        TimerWheel wheel(STEP, start);
+        for (size_t i = 0; i < ids.size(); i++) {
+            wheel.schedule(start + std::chrono::milliseconds(sleepTime(random)), {ids[i], 1});
+        }
+        std::deque<TimerWheel::Timer> expired;
+        auto begin = Clock::now();
+        wheel.advance(start + STALL_TIME, expired);
+        auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - begin);
+        return (double) elapsed.count() / 1000.0;
+    }
+
+    Result deadlineHeap(const std::vector<std::string> &ids) {
+        DeadlineHeap heap;
+        return simulate(ids, Clock::now(),
+                        [&](Clock::time_point deadline, const std::string &id, unsigned long generation) {
+                            heap.push({deadline, id, generation});
+                        },
+                        [&](Clock::time_point now, std::vector<std::pair<std::string, unsigned long>> &due) {
+                            while (!heap.empty() && heap.top().deadline <= now) {
+                                due.emplace_back(heap.top().controllerId, heap.top().generation);
+                                heap.pop();
+                            }
+                        });
+    }
+
+    void print(const char *name, int controllers, const Result &result) {
+        std::cout << name << " controllers=" << controllers
+                  << " schedule=" << result.scheduleNs << "ns"
+                  << " poll=" << result.pollNs << "ns"
+                  << " polls=" << result.polls << std::endl;
+    }
+}
+
+int main() {
+    for (int controllers: {10000, 100000}) {
+        auto ids = controllerIds(controllers);
+        print("timer wheel", controllers, timerWheel(ids));
+        print("deadline heap", controllers, deadlineHeap(ids));
+        std::cout << "timer wheel controllers=" << controllers << " advance after 24h stall=" << stallUs(ids) << "us"
+                  << std::endl;
+    }
+    return 0;
+}
@@ -2,6 +2,7 @@
 
 #include "ddi/hawkbit_response.hpp"
 #include "ddi/ddi_client.hpp"
+#include "ddi/gateway.hpp"
 
 /*! \page ddiModule ddi module description
  *  DDI module contains all required functionality for easy business logic development
@@ -34,4 +35,12 @@
  *   module documentation.
  *
  *  \link ddi::Client::run You can begin from here \endlink
+ *
+ *  Gateway that acts for many targets can poll all of them from one process with ddi::Gateway.
+ *
+ *  Long update can be finished in background: enable ddi::DDIClientBuilder::setAsyncDeployment and send feedback
+ *   of the deployment with ddi::ActionContext while client keeps polling.
+ *
+ *  mTLS certificate can be renewed before it expires (ddi::DDIClientBuilder::setCertificateRenewal), so polling
+ *   does not wait for HTTP_UNAUTHORIZED and new provisioning.
  */
\ No newline at end of file
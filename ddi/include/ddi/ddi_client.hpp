@@ -1,5 +1,7 @@
 #pragma once
 
+#include <exception>
+#include <functional>
 #include <string>
 #include <memory>
 
@@ -7,15 +9,65 @@
 
 namespace ddi {
 
+    ///\brief TLS session resumption counters.
+    /// Counters are reset when credentials are changed.
+    struct TLSSessionStatistics {
+        /// Handshakes that resumed cached session.
+        unsigned long hits = 0;
+        /// Full handshakes.
+        unsigned long misses = 0;
+    };
+
+    ///\brief Retry policy for requests failed by connection error or by temporary server error (408, 429, 5xx).
+    /*!
+    * Delay before every retry is random in [baseDelay, 3 * previous delay] (exponential backoff with decorrelated
+    *  jitter) and limited by maxDelay. If server sends Retry-After, delay is not less than requested one.
+    */
+    struct RetryPolicy {
+        /// How many times failed request is repeated. 0 disables retries.
+        int maxRetries = 3;
+        /// Min delay before retry (ms).
+        int baseDelay = 1000;
+        /// Max delay before retry (ms).
+        int maxDelay = 30000;
+    };
+
     /// \brief Main communication interface
     class Client {
     public:
 
         /*! Start client calling this method.
-        * This method realized as infinite, blocking loop
+        * This method realized as blocking loop. It returns when ddi::Client::stop is called.
+        * @throw client_initialize_error if client is already running.
         */
         virtual void run() = 0;
 
+        ///\brief Start polling loop in background thread and return immediately.
+        /*!
+        * @throw client_initialize_error if client is already running.
+        * @note Exception thrown from the loop stops it and is rethrown by ddi::Client::stop.
+        */
+        virtual void runAsync() = 0;
+
+        ///\brief Stop polling loop.
+        /*!
+        * Sleep between polls is interrupted. If poll is in progress, it is finished first,
+        *  so feedback for already handled action is delivered before this method returns.
+        * Can be called from event handler, in this case loop is finished after handler returns
+        *  and this method does not wait for it.
+        */
+        virtual void stop() = 0;
+
+        ///\brief Interrupt sleep between polls and poll hawkBit immediately.
+        /*!
+        * Triggers received before the poll is started are coalesced into a single poll.
+        *  Trigger received during the poll causes one more poll right after it.
+        */
+        virtual void pollNow() = 0;
+
+        ///\brief Get TLS session resumption statistics for hawkBit and download hosts.
+        virtual TLSSessionStatistics getTLSSessionStatistics() = 0;
+
         virtual ~Client() = default;
     };
 
@@ -71,12 +123,17 @@ namespace ddi {
         *  Note: in second after onAuthError was called, client will retry to do the same request
         *    with new auth params, but if server respond error again, exception will be thrown
         *    (in some cases you can catch it with ResponseDeliveryListener.
+        *  Note: request getting 401 may run on feedback sender or download thread, so onAuthError is called from it.
+        *    Calls are serialized. Parameters set with AuthRestoreHandler are applied together when onAuthError returns.
         */
         virtual void onAuthError(std::unique_ptr<AuthRestoreHandler>) = 0;
 
         virtual ~AuthErrorHandler() = default;
     };
 
+    ///\brief Receives error of failed poll (connection error or error response of hawkBit).
+    using ClientErrorHandler = std::function<void(const std::exception &)>;
+
     /// \brief Builder used for build and configure ddi::Client
     class DDIClientBuilder {
     public:
@@ -118,6 +175,109 @@ namespace ddi {
         /// @note ignored if TLS authorization type is set.
         virtual DDIClientBuilder *notVerifyServerCertificate() = 0;
 
+        ///\brief Set time (ms) after which unused keep-alive connection to hawkBit (or download server) will be closed.
+        /// Connections are reused by polling, feedback and download requests. Default value is 60000.
+        virtual DDIClientBuilder *setConnectionIdleTimeout(int idleTimeout) = 0;
+
+        ///\brief Set how many times interrupted artifact download will be resumed.
+        /// Download continues from the last received byte (HTTP Range request guarded by If-Range),
+        ///  already received data is kept. Default value is 3, 0 disables resuming.
+        /// @note Same as RetryPolicy::maxRetries of ddi::DDIClientBuilder::setDownloadRetryPolicy.
+        virtual DDIClientBuilder *setDownloadResumeAttempts(int attempts) = 0;
+
+        ///\brief Set retry policy of polling requests (controller base resource and action details).
+        /// If retries are exhausted, poll fails: ddi::Client::run stops, or continues if ddi::DDIClientBuilder::setPollErrorHandler is set.
+        virtual DDIClientBuilder *setPollRetryPolicy(const RetryPolicy &) = 0;
+
+        ///\brief Set handler of failed polls.
+        /*!
+        * Connection error or error response of hawkBit (when poll retries are exhausted) does not stop
+        *  ddi::Client::run: error is passed to handler and the next poll is delayed with backoff of poll
+        *  retry policy (not less than polling period). Failed delivery of feedback sent by ddi::ActionContext
+        *  is reported the same way, feedback stays queued. Errors of ddi::EventHandler still stop the client.
+        *  Without handler (default) these errors stop ddi::Client::run.
+        * @note Handler is called from polling thread.
+        */
+        virtual DDIClientBuilder *setPollErrorHandler(ClientErrorHandler) = 0;
+
+        ///\brief Set retry policy of feedback and config data requests.
+        virtual DDIClientBuilder *setFeedbackRetryPolicy(const RetryPolicy &) = 0;
+
+        ///\brief Set retry policy of artifact downloads. Interrupted download is resumed (see ddi::DDIClientBuilder::setDownloadResumeAttempts).
+        virtual DDIClientBuilder *setDownloadRetryPolicy(const RetryPolicy &) = 0;
+
+        ///\brief Enable parallel segmented download of large artifacts (disabled by default).
+        /*!
+        * Artifact bigger than segmentSize (bytes) is split into byte ranges, which are downloaded
+        *  using up to maxConnections connections and written on their positions into preallocated file
+        *  (disk space is allocated with posix_fallocate, on Windows only file size is set).
+        * If server ignores Range requests artifact is downloaded as single stream.
+        * @note Used only by ddi::Artifact::downloadTo. If hashes verification is requested, the first segment is
+        *  hashed while downloaded. Other segments are received out of order, so each one is read back once
+        *  the segments before it are complete. This runs while later segments are downloading.
+        */
+        virtual DDIClientBuilder *setSegmentedDownload(long long segmentSize, int maxConnections) = 0;
+
+        ///\brief Randomize polling period (disabled by default).
+        /*!
+        * Polls are scheduled at fixed rate (period is counted from the previous poll start, not from its end),
+        *  every period is randomly chosen in [pollingTimeout * (1 - ratio), pollingTimeout * (1 + ratio)].
+        * @param ratio value in [0, 1], ex: 0.1 - up to 10% deviation.
+        */
+        virtual DDIClientBuilder *setPollingJitter(double ratio) = 0;
+
+        ///\brief Delay first poll by random time in [0, maxSplay] ms (disabled by default).
+        /// Spreads requests of devices started at the same moment (ex: after power outage).
+        virtual DDIClientBuilder *setInitialSplay(int maxSplay) = 0;
+
+        ///\brief Listen on unix datagram socket for poll triggers.
+        /*!
+        * Any datagram sent to the socket has the same effect as ddi::Client::pollNow
+        *  (ex: echo | socat - UNIX-SENDTO:/run/up2date.sock). Existing file at path is replaced.
+        * @note Not supported on Windows, ddi::DDIClientBuilder::build throws client_initialize_error.
+        */
+        virtual DDIClientBuilder *setPollTriggerSocket(const std::string &path) = 0;
+
+        ///\brief Enable local artifacts cache (disabled by default).
+        /*!
+        * Downloaded artifacts are stored in dir by their sha256. If the same artifact is assigned again
+        *  ddi::Artifact::downloadTo and ddi::Artifact::downloadWithReceiver serve it from disk without network
+        *  requests. Cached file is checked against sha256 before use.
+        * @param maxSize max summary size of cached artifacts in bytes, least recently used ones are removed
+        *  when it is exceeded. 0 - unlimited.
+        */
+        virtual DDIClientBuilder *setArtifactCache(const std::string &dir, long long maxSize) = 0;
+
+        ///\brief Enable async deployment (disabled by default).
+        /*!
+        * Deployments are passed to ddi::EventHandler::onDeploymentActionAsync with ddi::ActionContext, so update
+        *  can be finished after handler returned while client keeps polling.
+        */
+        virtual DDIClientBuilder *setAsyncDeployment() = 0;
+
+        ///\brief Deliver action feedback from durable outbox (disabled by default).
+        /*!
+        * Feedback is appended to journal in dir and sent by background thread, so polling never waits for delivery.
+        *  Failed delivery is repeated with delays of feedback retry policy till it succeeds (when retries are
+        *  exhausted, every maxDelay ms). Feedback rejected by server with not retryable code is dropped.
+        *  Not delivered feedback survives restart and is sent when client is run again.
+        *  Pending PROCEEDING feedback of action is replaced by newer feedback of the same action.
+        *  Action which final feedback is not delivered yet is not passed to handler again.
+        * @note ddi::ResponseDeliveryListener is called from sender thread. Listeners are not restored after restart.
+        */
+        virtual DDIClientBuilder *setFeedbackOutbox(const std::string &dir) = 0;
+
+        ///\brief Renew mTLS certificate before it expires (disabled by default).
+        /*!
+        * When lifetimeFraction of certificate lifetime (notBefore..notAfter) passed, ddi::AuthErrorHandler::onAuthError
+        *  is called from background thread (ex. to issue new certificate with ritms::dps::ProvisioningClient).
+        *  Credentials set by handler are applied at once when it returns (requests started after it use them),
+        *  so polling is not stopped while certificate is issued. Renewal is attempted at most once a minute,
+        *  failed renewal (including one that returns certificate with the same notAfter) is repeated every minute.
+        * @param lifetimeFraction between 0 and 1 (ex. 0.7).
+        * @note Requires ddi::AuthErrorHandler. It is never called from two threads at the same time.
+        */
+        virtual DDIClientBuilder *setCertificateRenewal(double lifetimeFraction) = 0;
 
         ///\brief Set hawkBit endpoint.
         /*!
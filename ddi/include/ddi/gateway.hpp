@@ -0,0 +1,101 @@
+#pragma once
+
+#include <exception>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "ddi_client.hpp"
+#include "hawkbit_event_handler.hpp"
+
+namespace ddi {
+
+    ///\brief Called when poll of controller failed. Controller is polled again with backoff (see ddi::GatewayBuilder::setPollRetryPolicy).
+    using PollErrorHandler = std::function<void(const std::string &controllerId, const std::exception &)>;
+
+    /// \brief Polls many controllers (targets) from one process.
+    /*!
+     * Gateway acts for all added controllers with gateway token. Controllers share scheduler, worker threads,
+     *  keep-alive connections and TLS state, so thread count does not depend on controllers count.
+     * Every controller has its own ddi::EventHandler, which is called from one of worker threads.
+     */
+    class Gateway {
+    public:
+        ///\brief Add controller to polling. Controller is polled as soon as possible.
+        /// @throw client_initialize_error if controller with the same id is already added.
+        virtual void addController(const std::string &controllerId, std::shared_ptr<EventHandler> handler) = 0;
+
+        ///\brief Remove controller from polling. If controller is being polled, poll is finished first.
+        virtual void removeController(const std::string &controllerId) = 0;
+
+        ///\brief Poll controller as soon as possible (like ddi::Client::pollNow).
+        virtual void pollNow(const std::string &controllerId) = 0;
+
+        ///\brief Start polling and block till ddi::Gateway::stop is called.
+        virtual void run() = 0;
+
+        ///\brief Start polling in background and return immediately.
+        virtual void runAsync() = 0;
+
+        ///\brief Stop polling. Polls in progress are finished (with their feedback) before this method returns.
+        virtual void stop() = 0;
+
+        virtual ~Gateway() = default;
+    };
+
+    /// \brief Builder used for build and configure ddi::Gateway
+    class GatewayBuilder {
+    public:
+        ///\brief Get builder instance
+        static std::unique_ptr<GatewayBuilder> newInstance();
+
+        ///\brief Set hawkBit server. Controller endpoints are built as \<server\>/\<tenant\>/controller/v1/\<controllerId\>
+        /// @note Path of the first argument will be ignored.
+        virtual GatewayBuilder *setHawkbitEndpoint(const std::string &endpoint,
+                                                   const std::string &tenant = "default") = 0;
+
+        ///\brief Set gatewayToken. Required.
+        virtual GatewayBuilder *setGatewayToken(const std::string &) = 0;
+
+        ///\brief Set pollingTimeout used when it cannot be received from server.
+        virtual GatewayBuilder *setDefaultPollingTimeout(int pollingTimeout) = 0;
+
+        ///\brief Add header to all requests.
+        virtual GatewayBuilder *addHeader(const std::string &, const std::string &) = 0;
+
+        ///\brief Set not verify server certificate.
+        /// @note USE ONLY FOR DEBUG (if your server has self-signed certificate).
+        virtual GatewayBuilder *notVerifyServerCertificate() = 0;
+
+        ///\brief Set count of worker threads (max count of controllers polled at the same time). Default value is 4.
+        virtual GatewayBuilder *setWorkersCount(int workers) = 0;
+
+        ///\brief Set time (ms) after which unused keep-alive connection will be closed. Default value is 60000.
+        virtual GatewayBuilder *setConnectionIdleTimeout(int idleTimeout) = 0;
+
+        ///\brief Randomize polling period of every controller (see ddi::DDIClientBuilder::setPollingJitter).
+        virtual GatewayBuilder *setPollingJitter(double ratio) = 0;
+
+        ///\brief Delay first poll of every added controller by random time in [0, maxSplay] ms.
+        virtual GatewayBuilder *setInitialSplay(int maxSplay) = 0;
+
+        ///\brief Set backoff of failed controller polls (default is ddi::RetryPolicy defaults).
+        /*!
+        * Failed request is not repeated inside poll, so worker is not blocked by one unavailable controller.
+        *  Instead failed controller is polled again after backoff delay of policy (not less than polling period).
+        *  When maxRetries is reached delay stays at maxDelay till poll succeeds.
+        */
+        virtual GatewayBuilder *setPollRetryPolicy(const RetryPolicy &) = 0;
+
+        ///\brief Set handler of poll errors. By default, errors are ignored.
+        /// Error not derived from std::exception is passed as std::runtime_error("unknown error").
+        virtual GatewayBuilder *setPollErrorHandler(PollErrorHandler) = 0;
+
+        ///\brief Enable async deployment of all controllers (see ddi::DDIClientBuilder::setAsyncDeployment).
+        virtual GatewayBuilder *setAsyncDeployment() = 0;
+
+        virtual std::unique_ptr<Gateway> build() = 0;
+
+        virtual ~GatewayBuilder() = default;
+    };
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <future>
+#include <memory>
+#include <string>
+
+#include "hawkbit_response.hpp"
+#include "hawkbit_actions.hpp"
+
+namespace ddi {
+
+    ///\brief Deployment action that is finished after handler returned (see ddi::EventHandler::onDeploymentActionAsync).
+    /*!
+    * Handler returns ddi::Response with PROCEEDING execution right away, does the update in background and sends
+    *  the rest of feedback with ddi::ActionContext::sendFeedback. Client keeps polling meanwhile, so cancelAction
+    *  for the deployment is received while it is in progress.
+    * All methods are thread-safe.
+    */
+    class ActionContext {
+    public:
+        ///\brief Get action id.
+        virtual int getActionId() = 0;
+
+        ///\brief Send feedback of action. Feedback is queued and sent by polling thread as soon as possible.
+        /*!
+        * Feedback with CLOSED, CANCELED or REJECTED execution finishes action, feedback sent after it is ignored.
+        *  Delivery is reported to ddi::ResponseDeliveryListener of response.
+        */
+        virtual void sendFeedback(std::unique_ptr<Response>) = 0;
+
+        ///\brief Download artifact in background (see ddi::Artifact::downloadTo).
+        /*!
+        * @param verify combination of ddi::HashVerify values.
+        * @return future that is ready when download is finished. Download error is rethrown by std::future::get.
+        * @note cancelAction received for deployment aborts its running downloads (started by context or directly
+        *  by ddi::Artifact) with ddi::download_canceled.
+        * @note Client should not be destroyed till download is finished.
+        */
+        virtual std::future<void> downloadTo(std::shared_ptr<Artifact>, const std::string &path, int verify) = 0;
+
+        ///\brief Check if cancelAction for this action was received.
+        virtual bool isCanceled() = 0;
+
+        virtual ~ActionContext() = default;
+    };
+
+}
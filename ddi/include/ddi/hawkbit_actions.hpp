@@ -2,6 +2,8 @@
 
 #include <string>
 #include <functional>
+#include <memory>
+#include <vector>
 
 namespace ddi {
     // This part contains actions that will be given to the EventHandler callbacks.
@@ -26,11 +28,29 @@ namespace ddi {
         std::string sha256;
     };
 
+    ///\brief Hashes that are checked while artifact is being downloaded.
+    /// Values can be combined (ex: VERIFY_SHA256 | VERIFY_MD5).
+    enum HashVerify {
+        VERIFY_NONE = 0,
+        VERIFY_MD5 = 1,
+        VERIFY_SHA1 = 2,
+        VERIFY_SHA256 = 4,
+        VERIFY_ALL = VERIFY_MD5 | VERIFY_SHA1 | VERIFY_SHA256
+    };
+
     class Artifact {
     public:
         ///\brief Save file to path.
         virtual void downloadTo(std::string path) = 0;
 
+        ///\brief Save file to path and check received data against \link ddi::Hashes Hashes \endlink.
+        /*!
+        * Hashes are calculated on the fly from received blocks, so file is not read again after download.
+        * @param verify combination of ddi::HashVerify values.
+        * @note If file does not match, it will be removed and ddi::artifact_verification_error will be thrown.
+        */
+        virtual void downloadTo(std::string path, int verify) = 0;
+
         ///\brief Get response body as string.
         virtual std::string getBody() = 0;
 
@@ -38,13 +58,29 @@ namespace ddi {
         /// @note Return true from function to continue false to stop downloading.
         virtual void downloadWithReceiver(std::function<bool(const char *data, size_t data_length)>) = 0;
 
+        ///\brief Get file with user-defined Receiver and check received data against \link ddi::Hashes Hashes \endlink.
+        /*!
+        * @param verify combination of ddi::HashVerify values.
+        * @note ddi::artifact_verification_error is thrown after the last block was passed to receiver,
+        *  so received data should be discarded in this case.
+        */
+        virtual void downloadWithReceiver(std::function<bool(const char *data, size_t data_length)>, int verify) = 0;
+
         ///\brief Get file name.
         virtual std::string getFilename() = 0;
 
+        ///\brief Get file name without copying.
+        /// @note Reference is valid while artifact exists.
+        virtual const std::string &getFilenameRef() = 0;
+
         ///\brief Get Hashes struct that contain hashes.
         /// @note Can be used for check received file health.
         virtual Hashes getFileHashes() = 0;
 
+        ///\brief Get hashes without copying.
+        /// @note Reference is valid while artifact exists.
+        virtual const Hashes &getFileHashesRef() = 0;
+
         ///\brief Get file size.
         virtual int size() = 0;
 
@@ -65,9 +101,42 @@ namespace ddi {
         ///\brief Get \link ddi::Artifact Artifacts \endlink assigned to this chunk.
         virtual std::vector<std::shared_ptr<Artifact>> getArtifacts() = 0;
 
+        ///\brief Get count of \link ddi::Artifact Artifacts \endlink assigned to this chunk.
+        virtual size_t artifactsCount() = 0;
+
+        ///\brief Get artifact by index in [0, artifactsCount()) without copying artifacts list.
+        /// @note Reference is valid while chunk exists. std::out_of_range is thrown if index is invalid.
+        virtual Artifact &artifactAt(size_t index) = 0;
+
         virtual ~Chunk() = default;
     };
 
+    ///\brief Options for ddi::DeploymentBase::downloadAll.
+    struct DownloadOptions {
+        ///\brief Max count of artifacts downloaded at the same time.
+        int maxParallel = 4;
+
+        ///\brief Hashes checked while downloading (combination of ddi::HashVerify values).
+        int verify = VERIFY_NONE;
+
+        ///\brief Called when download progress is changed.
+        /// Gets bytes received for all artifacts and sum of artifact sizes. Calls are not concurrent.
+        std::function<void(long long downloaded, long long total)> onProgress;
+    };
+
+    ///\brief Result of single artifact download in ddi::DeploymentBase::downloadAll.
+    struct ArtifactDownloadResult {
+        std::shared_ptr<Artifact> artifact;
+
+        ///\brief Path where artifact is saved.
+        std::string path;
+
+        bool success = false;
+
+        ///\brief Error description if download failed.
+        std::string error;
+    };
+
     ///\brief Data for deployment base (update) request.
     ///  <br><a href="https://www.eclipse.org/hawkbit/rest-api/rootcontroller-api-guide/#_deployment_or_update_action">docs</a>
     /// Structure of this package is equals to response fields in <a href="https://www.eclipse.org/hawkbit/rest-api/rootcontroller-api-guide/#_response_fields_4">structure</a><br>
@@ -100,6 +169,22 @@ namespace ddi {
         ///\brief Return assigned \link ddi::Chunk chunks \endlink
         virtual std::vector<std::shared_ptr<Chunk>> getChunks() = 0;
 
+        ///\brief Get count of assigned \link ddi::Chunk chunks \endlink.
+        virtual size_t chunksCount() = 0;
+
+        ///\brief Get chunk by index in [0, chunksCount()) without copying chunks list.
+        /// @note Reference is valid while deployment exists. std::out_of_range is thrown if index is invalid.
+        virtual Chunk &chunkAt(size_t index) = 0;
+
+        ///\brief Download artifacts of all chunks to directory.
+        /*!
+        * Artifacts are downloaded concurrently (up to DownloadOptions::maxParallel at the same time)
+        *  and saved as dir/filename. Failed download does not stop others.
+        * @return result for every artifact in order of chunks.
+        */
+        virtual std::vector<ArtifactDownloadResult> downloadAll(const std::string &dir,
+                                                                const DownloadOptions &options) = 0;
+
         virtual ~DeploymentBase() = default;
     };
 
@@ -1,9 +1,11 @@
 #pragma once
 
 #include <memory>
+#include <utility>
 
 #include "hawkbit_response.hpp"
 #include "hawkbit_actions.hpp"
+#include "hawkbit_action_context.hpp"
 
 namespace ddi {
 
@@ -17,6 +19,18 @@ namespace ddi {
         ///\brief  Called when hawkBit request to start (queue) update.
         virtual std::unique_ptr<Response> onDeploymentAction(std::unique_ptr<DeploymentBase>) = 0;
 
+        ///\brief  Called instead of onDeploymentAction if async deployment is enabled
+        /// (ddi::DDIClientBuilder::setAsyncDeployment).
+        /*!
+        * Return response with PROCEEDING execution to finish update in background with ddi::ActionContext.
+        *  Deployment is not passed to handler again till its final feedback is sent.
+        *  By default deployment is processed by onDeploymentAction.
+        */
+        virtual std::unique_ptr<Response> onDeploymentActionAsync(std::unique_ptr<DeploymentBase> deployment,
+                                                                  std::shared_ptr<ActionContext>) {
+            return onDeploymentAction(std::move(deployment));
+        }
+
         ///\brief  Called when hawkBit request to stop current update.
         virtual std::unique_ptr<Response> onCancelAction(std::unique_ptr<CancelAction>) = 0;
 
@@ -1,9 +1,13 @@
 #pragma once
 
+#include "hawkbit_actions.hpp"
+
 namespace ddi {
     const int HTTP_UNAUTHORIZED = 401;
     const int HTTP_OK = 200;
     const int HTTP_CREATED = 201;
+    const int HTTP_PARTIAL_CONTENT = 206;
+    const int HTTP_NOT_MODIFIED = 304;
 
     const std::string UNAUTHORIZED_ERROR_MESSAGE = "Got " + std::to_string(HTTP_UNAUTHORIZED) + " code";
 
@@ -18,13 +22,19 @@ namespace ddi {
     ///\brief  Unexpected HTTP code.
     class http_unexpected_code_exception : public std::exception {
         std::string message;
+        int code;
 
     public:
-        http_unexpected_code_exception(int presented, int expected) {
+        http_unexpected_code_exception(int presented, int expected) : code(presented) {
             message = "Unexpected code. Got " + std::to_string(presented) + " (expected " + std::to_string(expected) +
                       ")";
         }
 
+        ///\brief Get received HTTP code.
+        int getCode() const {
+            return code;
+        }
+
         const char *what() const noexcept override {
             return message.c_str();
         }
@@ -58,6 +68,37 @@ namespace ddi {
         }
     };
 
+    ///\brief  Downloaded artifact does not match hashes received from hawkBit.
+    class artifact_verification_error : public std::exception {
+        std::string message;
+        int failed;
+    public:
+        explicit artifact_verification_error(int failed_) : failed(failed_) {
+            message = "Artifact verification failed. Mismatched hashes:";
+            if (failed & VERIFY_MD5) message += " md5";
+            if (failed & VERIFY_SHA1) message += " sha1";
+            if (failed & VERIFY_SHA256) message += " sha256";
+        }
+
+        ///\brief Get mismatched hashes (combination of ddi::HashVerify values).
+        int getFailedHashes() const {
+            return failed;
+        }
+
+        const char *what() const noexcept override {
+            return message.c_str();
+        }
+    };
+
+    ///\brief  Artifact download is aborted because hawkBit canceled the deployment.
+    /// Cancel should be confirmed by ddi::EventHandler::onCancelAction response.
+    class download_canceled : public std::exception {
+    public:
+        const char *what() const noexcept override {
+            return "download canceled";
+        }
+    };
+
     ///\brief  Some required fields for ddi::Client are missing
     class client_initialize_error : public std::exception {
         std::string message;
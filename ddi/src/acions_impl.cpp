@@ -1,9 +1,17 @@
-#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <stdexcept>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include "actions_impl.hpp"
-#include "rapidjson/document.h"
+#include "hash_verifier.hpp"
 #include "ddi_client_impl.hpp"
+#include "json_path_reader.hpp"
 #include "utils.hpp"
 
 namespace ddi {
@@ -15,100 +23,241 @@ namespace ddi {
         return stopId;
     }
 
-    std::unique_ptr<CancelAction> CancelAction_::fromString(const std::string &body) {
-        rapidjson::Document document;
-        document.Parse<0>(body.c_str());
+    // hawkBit sends action ids as strings
+    bool parseId(const char *str, size_t length, int &id) {
+        if (length == 0 || length > 9) {
+            return false;
+        }
+        id = 0;
+        for (size_t i = 0; i < length; i++) {
+            if (str[i] < '0' || str[i] > '9') {
+                return false;
+            }
+            id = id * 10 + (str[i] - '0');
+        }
+        return true;
+    }
 
-        if (document.HasParseError())
-            throw unexpected_payload();
+    bool parseId(int64_t value, int &id) {
+        if (value < 0 || value > INT32_MAX) {
+            return false;
+        }
+        id = (int) value;
+        return true;
+    }
 
-        if (!document.HasMember("id")) {
-            throw unexpected_payload();
+    const std::string ID_PATH = "/id";
+    const std::string STOP_ID_PATH = "/cancelAction/stopId";
+
+    class CancelActionReader : public JsonPathReader {
+    public:
+        explicit CancelActionReader(CancelAction_ &cancelAction_) : cancelAction(cancelAction_) {}
+
+        bool isComplete() const {
+            return hasId && hasStopId;
         }
-        if (!document.HasMember("cancelAction") || !document["cancelAction"].HasMember("stopId")) {
-            throw unexpected_payload();
+
+    protected:
+        bool onString(const std::string &path, const char *str, size_t length) override {
+            if (path == ID_PATH) {
+                return hasId = parseId(str, length, cancelAction.id);
+            } else if (path == STOP_ID_PATH) {
+                return hasStopId = parseId(str, length, cancelAction.stopId);
+            }
+            return true;
         }
 
+        bool onInteger(const std::string &path, int64_t value) override {
+            if (path == ID_PATH) {
+                return hasId = parseId(value, cancelAction.id);
+            } else if (path == STOP_ID_PATH) {
+                return hasStopId = parseId(value, cancelAction.stopId);
+            }
+            return true;
+        }
+
+    private:
+        CancelAction_ &cancelAction;
+        bool hasId = false;
+        bool hasStopId = false;
+    };
+
+    std::unique_ptr<CancelAction> CancelAction_::fromString(const std::string &body, JsonArena &arena) {
         auto cancelAction = new CancelAction_();
         // if exception while parsing memory will be cleared
         auto retAction = std::unique_ptr<CancelAction>(cancelAction);
 
-        cancelAction->stopId = std::stoi(document["cancelAction"]["stopId"].GetString());
-        cancelAction->id = std::stoi(document["id"].GetString());
+        CancelActionReader reader(*cancelAction);
+        reader.parse(body, arena);
+        if (!reader.isComplete()) {
+            throw unexpected_payload();
+        }
 
         return retAction;
     }
 
-
-    std::unique_ptr<DeploymentBase> DeploymentBase_::from(const std::string &body, DownloadProvider *requestFormatter) {
-        rapidjson::Document document;
-        document.Parse<0>(body.c_str());
-
-        if (document.HasParseError())
-            throw unexpected_payload();
-
-        if (!document.HasMember("id") || !document.HasMember("deployment") ||
-            !document["deployment"].HasMember("update") || !document["deployment"].HasMember("download")
-            || !document["deployment"].HasMember("chunks")) {
-            throw unexpected_payload();
+    const std::string UPDATE_PATH = "/deployment/update";
+    const std::string DOWNLOAD_PATH = "/deployment/download";
+    const std::string MAINTENANCE_WINDOW_PATH = "/deployment/maintenanceWindow";
+    const std::string CHUNKS_PATH = "/deployment/chunks";
+    const std::string CHUNK_PATH = CHUNKS_PATH + "/[]";
+    const std::string CHUNK_PART_PATH = CHUNK_PATH + "/part";
+    const std::string CHUNK_VERSION_PATH = CHUNK_PATH + "/version";
+    const std::string CHUNK_NAME_PATH = CHUNK_PATH + "/name";
+    const std::string CHUNK_ARTIFACTS_PATH = CHUNK_PATH + "/artifacts";
+    const std::string ARTIFACT_PATH = CHUNK_ARTIFACTS_PATH + "/[]";
+    const std::string ARTIFACT_FILENAME_PATH = ARTIFACT_PATH + "/filename";
+    const std::string ARTIFACT_SIZE_PATH = ARTIFACT_PATH + "/size";
+    const std::string ARTIFACT_SHA256_PATH = ARTIFACT_PATH + "/hashes/sha256";
+    const std::string ARTIFACT_SHA1_PATH = ARTIFACT_PATH + "/hashes/sha1";
+    const std::string ARTIFACT_MD5_PATH = ARTIFACT_PATH + "/hashes/md5";
+    const std::string ARTIFACT_HREF_PATH = ARTIFACT_PATH + "/_links/download-http/href";
+
+    // Fills deployment in one pass. Chunk/artifact is created when its object starts and
+    //  checked for required fields when the object ends.
+    class DeploymentBaseReader : public JsonPathReader {
+    public:
+        DeploymentBaseReader(DeploymentBase_ &deploymentBase_, DownloadProvider *downloadProvider_)
+                : deploymentBase(deploymentBase_), downloadProvider(downloadProvider_) {}
+
+        bool isComplete() const {
+            return deploymentFields == ALL_DEPLOYMENT_FIELDS;
         }
 
-        auto deploymentBase = new DeploymentBase_();
-        // if exception while parsing memory will be cleared
-        auto retBase = std::unique_ptr<DeploymentBase>(deploymentBase);
-
-        deploymentBase->id = std::stoi(document["id"].GetString());
-        deploymentBase->updateType = document["deployment"]["update"].GetString();
-        deploymentBase->downloadType = document["deployment"]["download"].GetString();
-
-        if (document["deployment"].HasMember("maintenanceWindow")) {
-            std::string window = document["deployment"]["maintenanceWindow"].GetString();
-            deploymentBase->inMaintenanceWindow = window != "unavailable";
-        } else {
-            deploymentBase->inMaintenanceWindow = true;
+    protected:
+        bool onString(const std::string &path, const char *str, size_t length) override {
+            if (artifact) {
+                if (path == ARTIFACT_FILENAME_PATH) {
+                    artifact->filename.assign(str, length);
+                    artifactFields |= FILENAME;
+                } else if (path == ARTIFACT_SHA256_PATH) {
+                    artifact->fileHash.sha256.assign(str, length);
+                    artifactFields |= SHA256;
+                } else if (path == ARTIFACT_SHA1_PATH) {
+                    artifact->fileHash.sha1.assign(str, length);
+                    artifactFields |= SHA1;
+                } else if (path == ARTIFACT_MD5_PATH) {
+                    artifact->fileHash.md5.assign(str, length);
+                    artifactFields |= MD5;
+                } else if (path == ARTIFACT_HREF_PATH) {
+                    artifact->downloadURI = parseHref(str, length);
+                    artifactFields |= HREF;
+                }
+            } else if (chunk) {
+                if (path == CHUNK_PART_PATH) {
+                    chunk->part.assign(str, length);
+                    chunkFields |= PART;
+                } else if (path == CHUNK_VERSION_PATH) {
+                    chunk->version.assign(str, length);
+                    chunkFields |= VERSION;
+                } else if (path == CHUNK_NAME_PATH) {
+                    chunk->name.assign(str, length);
+                    chunkFields |= NAME;
+                }
+            } else if (path == ID_PATH) {
+                deploymentFields |= ID;
+                return parseId(str, length, deploymentBase.id);
+            } else if (path == UPDATE_PATH) {
+                deploymentBase.updateType.assign(str, length);
+                deploymentFields |= UPDATE;
+            } else if (path == DOWNLOAD_PATH) {
+                deploymentBase.downloadType.assign(str, length);
+                deploymentFields |= DOWNLOAD;
+            } else if (path == MAINTENANCE_WINDOW_PATH) {
+                deploymentBase.inMaintenanceWindow = std::string(str, length) != "unavailable";
+            }
+            return true;
         }
 
-        const rapidjson::Value &chunks_ = document["deployment"]["chunks"];
-        for (rapidjson::Value::ConstValueIterator itr = chunks_.Begin(); itr != chunks_.End(); ++itr) {
-            const rapidjson::Value &chunk = *itr;
-            if (!chunk.HasMember("part") || !chunk.HasMember("version") || !chunk.HasMember("name")
-                || !chunk.HasMember("artifacts")) {
-                throw unexpected_payload();
+        bool onInteger(const std::string &path, int64_t value) override {
+            if (artifact && path == ARTIFACT_SIZE_PATH) {
+                if (value < 0 || value > INT32_MAX) {
+                    return false;
+                }
+                artifact->fileSize = (int) value;
+                artifactFields |= SIZE;
+            } else if (!chunk && path == ID_PATH) {
+                deploymentFields |= ID;
+                return parseId(value, deploymentBase.id);
             }
+            return true;
+        }
 
-            auto chunkR = new Chunk_();
-            auto chunkPtr = std::shared_ptr<Chunk>(chunkR);
+        bool onObjectStart(const std::string &path) override {
+            // objects are added to the end of flat arrays, so pointer to the current one is valid till it ends
+            auto &storage = *deploymentBase.storage;
+            if (chunk && !artifact && path == ARTIFACT_PATH) {
+                storage.artifacts.emplace_back();
+                artifact = &storage.artifacts.back();
+                artifact->downloadProvider = downloadProvider;
+                artifact->cancellation = storage.cancellation.get();
+                chunk->artifactsEnd = storage.artifacts.size();
+                artifactFields = 0;
+            } else if (!chunk && path == CHUNK_PATH) {
+                storage.chunks.emplace_back();
+                chunk = &storage.chunks.back();
+                chunk->storage = &storage;
+                chunk->artifactsBegin = chunk->artifactsEnd = storage.artifacts.size();
+                chunkFields = 0;
+            }
+            return true;
+        }
 
-            chunkR->name = chunk["name"].GetString();
-            chunkR->version = chunk["version"].GetString();
-            chunkR->part = chunk["part"].GetString();
+        bool onObjectEnd(const std::string &path) override {
+            if (artifact && path == ARTIFACT_PATH) {
+                artifact = nullptr;
+                return artifactFields == ALL_ARTIFACT_FIELDS;
+            } else if (chunk && !artifact && path == CHUNK_PATH) {
+                chunk = nullptr;
+                return chunkFields == ALL_CHUNK_FIELDS;
+            }
+            return true;
+        }
 
-            const rapidjson::Value &artifacts_ = chunk["artifacts"];
-            for (rapidjson::Value::ConstValueIterator itr_a = artifacts_.Begin(); itr_a != artifacts_.End(); ++itr_a) {
-                const rapidjson::Value &artifact = *itr_a;
-                if (!artifact.HasMember("filename") || !artifact.HasMember("hashes") || !artifact.HasMember("size")
-                    || !artifact.HasMember("_links") || !artifact["hashes"].HasMember("sha256")
-                    || !artifact["hashes"].HasMember("sha1") || !artifact["hashes"].HasMember("md5")
-                    || !artifact["_links"].HasMember("download-http")) {
-                    throw unexpected_payload();
-                }
-                Hashes hashesR;
-                auto artifactR = new Artifact_();
-                auto artifactPtr = std::shared_ptr<Artifact>(artifactR);
-                artifactR->filename = artifact["filename"].GetString();
-                artifactR->fileSize = artifact["size"].GetInt();
-                artifactR->downloadURI = parseHrefObject(artifact["_links"]["download-http"]);
-                hashesR.md5 = artifact["hashes"]["md5"].GetString();
-                hashesR.sha1 = artifact["hashes"]["sha1"].GetString();
-                hashesR.sha256 = artifact["hashes"]["sha256"].GetString();
-                artifactR->fileHash = hashesR;
-                artifactR->downloadProvider = requestFormatter;
-
-                chunkR->artifacts.push_back(artifactPtr);
+        bool onArrayStart(const std::string &path) override {
+            if (chunk && !artifact && path == CHUNK_ARTIFACTS_PATH) {
+                chunkFields |= ARTIFACTS;
+            } else if (!chunk && path == CHUNKS_PATH) {
+                deploymentFields |= CHUNKS;
             }
+            return true;
+        }
+
+    private:
+        // required fields
+        enum {
+            ID = 1, UPDATE = 2, DOWNLOAD = 4, CHUNKS = 8, ALL_DEPLOYMENT_FIELDS = 15
+        };
+        enum {
+            PART = 1, VERSION = 2, NAME = 4, ARTIFACTS = 8, ALL_CHUNK_FIELDS = 15
+        };
+        enum {
+            FILENAME = 1, SIZE = 2, SHA256 = 4, SHA1 = 8, MD5 = 16, HREF = 32, ALL_ARTIFACT_FIELDS = 63
+        };
+
+        DeploymentBase_ &deploymentBase;
+        DownloadProvider *downloadProvider;
+        // currently parsed objects, nullptr if outside
+        Chunk_ *chunk = nullptr;
+        Artifact_ *artifact = nullptr;
+        int deploymentFields = 0;
+        int chunkFields = 0;
+        int artifactFields = 0;
+    };
+
+    std::unique_ptr<DeploymentBase> DeploymentBase_::from(const std::string &body, DownloadProvider *requestFormatter,
+                                                          JsonArena &arena) {
+        auto deploymentBase = new DeploymentBase_();
+        // if exception while parsing memory will be cleared
+        auto retBase = std::unique_ptr<DeploymentBase>(deploymentBase);
+        deploymentBase->inMaintenanceWindow = true;
 
-            deploymentBase->chunks.push_back(chunkPtr);
+        DeploymentBaseReader reader(*deploymentBase, requestFormatter);
+        reader.parse(body, arena);
+        if (!reader.isComplete()) {
+            throw unexpected_payload();
         }
+
         return retBase;
     }
 
@@ -130,9 +279,76 @@ namespace ddi {
     }
 
     std::vector<std::shared_ptr<Chunk>> DeploymentBase_::getChunks() {
+        std::vector<std::shared_ptr<Chunk>> chunks;
+        chunks.reserve(storage->chunks.size());
+        for (auto &chunk: storage->chunks) {
+            chunks.push_back(std::shared_ptr<Chunk>(storage, &chunk));
+        }
         return chunks;
     }
 
+    size_t DeploymentBase_::chunksCount() {
+        return storage->chunks.size();
+    }
+
+    Chunk &DeploymentBase_::chunkAt(size_t index) {
+        return storage->chunks.at(index);
+    }
+
+    std::vector<ArtifactDownloadResult> DeploymentBase_::downloadAll(const std::string &dir,
+                                                                     const DownloadOptions &options) {
+        // artifacts are stored in order of chunks
+        auto &artifacts = storage->artifacts;
+        std::vector<ArtifactDownloadResult> results(artifacts.size());
+        long long total = 0;
+        for (size_t i = 0; i < artifacts.size(); i++) {
+            auto &result = results[i];
+            result.artifact = std::shared_ptr<Artifact>(storage, &artifacts[i]);
+            result.path = dir.empty() || dir.back() == '/' ? dir + artifacts[i].filename
+                                                           : dir + "/" + artifacts[i].filename;
+            total += artifacts[i].fileSize;
+        }
+
+        std::mutex progressMutex;
+        long long downloaded = 0;
+        std::function<void(long long)> onProgress;
+        if (options.onProgress) {
+            onProgress = [&](long long received) {
+                std::lock_guard<std::mutex> lock(progressMutex);
+                downloaded += received;
+                options.onProgress(downloaded, total);
+            };
+        }
+
+        std::atomic<size_t> next{0};
+        auto worker = [&]() {
+            for (auto i = next++; i < results.size(); i = next++) {
+                auto &result = results[i];
+                try {
+                    artifacts[i].downloadTo(result.path, options.verify, onProgress);
+                    result.success = true;
+                } catch (std::exception &e) {
+                    result.error = e.what();
+                }
+            }
+        };
+
+        std::vector<std::thread> workers;
+        auto workersCount = std::min<size_t>((size_t) std::max(options.maxParallel, 1), results.size());
+        for (size_t i = 0; i < workersCount; i++) {
+            workers.emplace_back(worker);
+        }
+        for (auto &w: workers) {
+            w.join();
+        }
+
+        return results;
+    }
+
+    std::shared_ptr<CancellationToken> DeploymentBase_::getCancellation() {
+        return storage->cancellation;
+    }
+
     std::string Chunk_::getPart() {
         return part;
     }
@@ -146,11 +362,62 @@ namespace ddi {
     }
 
     std::vector<std::shared_ptr<Artifact>> Chunk_::getArtifacts() {
+        auto owner = storage->shared_from_this();
+        std::vector<std::shared_ptr<Artifact>> artifacts;
+        artifacts.reserve(artifactsEnd - artifactsBegin);
+        for (auto i = artifactsBegin; i < artifactsEnd; i++) {
+            artifacts.push_back(std::shared_ptr<Artifact>(owner, &storage->artifacts[i]));
+        }
         return artifacts;
     }
 
+    size_t Chunk_::artifactsCount() {
+        return artifactsEnd - artifactsBegin;
+    }
+
+    Artifact &Chunk_::artifactAt(size_t index) {
+        if (index >= artifactsCount()) {
+            throw std::out_of_range("artifact index is out of range");
+        }
+        return storage->artifacts[artifactsBegin + index];
+    }
+
+    DownloadRequest Artifact_::newDownloadRequest(HashVerifier *verifier) {
+        DownloadRequest request;
+        request.uri = downloadURI;
+        request.size = fileSize;
+        request.verifier = verifier;
+        request.sha256 = fileHash.sha256;
+        request.cancellation = cancellation;
+        return request;
+    }
+
     void Artifact_::downloadTo(std::string path) {
-        downloadProvider->downloadTo(downloadURI, path);
+        downloadProvider->downloadTo(newDownloadRequest(nullptr), path);
+    }
+
+    void Artifact_::downloadTo(std::string path, int verify) {
+        downloadTo(path, verify, nullptr);
+    }
+
+    void Artifact_::downloadTo(const std::string &path, int verify,
+                               const std::function<void(long long)> &onProgress) {
+        if (verify == VERIFY_NONE) {
+            auto request = newDownloadRequest(nullptr);
+            request.onProgress = onProgress;
+            return downloadProvider->downloadTo(request, path);
+        }
+
+        HashVerifier verifier(fileHash, verify);
+        auto request = newDownloadRequest(&verifier);
+        request.onProgress = onProgress;
+        downloadProvider->downloadTo(request, path);
+        try {
+            verifier.verify();
+        } catch (artifact_verification_error &) {
+            std::remove(path.c_str());
+            throw;
+        }
     }
 
     std::string Artifact_::getBody() {
@@ -158,17 +425,35 @@ namespace ddi {
     }
 
     void Artifact_::downloadWithReceiver(std::function<bool(const char *, size_t)> func) {
-        downloadProvider->downloadWithReceiver(downloadURI, func);
+        downloadProvider->downloadWithReceiver(newDownloadRequest(nullptr), func);
+    }
+
+    void Artifact_::downloadWithReceiver(std::function<bool(const char *, size_t)> func, int verify) {
+        if (verify == VERIFY_NONE) {
+            return downloadWithReceiver(func);
+        }
+
+        HashVerifier verifier(fileHash, verify);
+        downloadProvider->downloadWithReceiver(newDownloadRequest(&verifier), func);
+        verifier.verify();
     }
 
     std::string Artifact_::getFilename() {
         return filename;
     }
 
+    const std::string &Artifact_::getFilenameRef() {
+        return filename;
+    }
+
     Hashes Artifact_::getFileHashes() {
         return fileHash;
     }
 
+    const Hashes &Artifact_::getFileHashesRef() {
+        return fileHash;
+    }
+
     int Artifact_::size() {
         return fileSize;
     }
@@ -185,14 +470,83 @@ namespace ddi {
         return followURI;
     }
 
-    std::unique_ptr<PollingData_> PollingData_::fromString(const std::string &body) {
-        rapidjson::Document document;
-        document.Parse<0>(body.c_str());
+    const std::string SLEEP_PATH = "/config/polling/sleep";
+
+    struct LinkPath {
+        Actions_ action;
+        std::string path;
+        std::string hrefPath;
+    };
+
+    // there`re 3 variants of actions: configData, deploymentBase, cancelAction
+    // priority: configData, (cancelAction/deploymentBase)
+    const LinkPath LINK_PATHS[] = {
+            {Actions_::GET_CONFIG_DATA, "/_links/configData", "/_links/configData/href"},
+            {Actions_::CANCEL_ACTION, "/_links/cancelAction", "/_links/cancelAction/href"},
+            {Actions_::DEPLOYMENT_BASE, "/_links/deploymentBase", "/_links/deploymentBase/href"}
+    };
+    const size_t LINKS_COUNT = sizeof(LINK_PATHS) / sizeof(LINK_PATHS[0]);
+
+    class PollingDataReader : public JsonPathReader {
+    public:
+        explicit PollingDataReader(PollingData_ &data_) : data(data_) {}
+
+        // choose action from received links and parse sleep time
+        void finish() {
+            if (!sleepTime.empty()) {
+                int hh, mm, ss;
+                if (sscanf(sleepTime.c_str(), "%d:%d:%d", &hh, &mm, &ss) != 3) {
+                    throw unexpected_payload();
+                }
+                data.sleepTime = (hh * 3600 + mm * 60 + ss) * 1000;
+            }
 
-        if (document.HasParseError())
-            throw unexpected_payload();
+            for (size_t i = 0; i < LINKS_COUNT; i++) {
+                if (links[i].present) {
+                    data.action = LINK_PATHS[i].action;
+                    data.followURI = parseHref(links[i].href.data(), links[i].href.size());
+                    return;
+                }
+            }
+        }
 
+    protected:
+        bool onString(const std::string &path, const char *str, size_t length) override {
+            if (path == SLEEP_PATH) {
+                sleepTime.assign(str, length);
+                return true;
+            }
+            for (size_t i = 0; i < LINKS_COUNT; i++) {
+                if (path == LINK_PATHS[i].hrefPath) {
+                    links[i].href.assign(str, length);
+                    break;
+                }
+            }
+            return true;
+        }
 
+        bool onObjectStart(const std::string &path) override {
+            for (size_t i = 0; i < LINKS_COUNT; i++) {
+                if (path == LINK_PATHS[i].path) {
+                    links[i].present = true;
+                    break;
+                }
+            }
+            return true;
+        }
+
+    private:
+        struct Link {
+            bool present = false;
+            std::string href;
+        };
+
+        PollingData_ &data;
+        std::string sleepTime;
+        Link links[LINKS_COUNT];
+    };
+
+    std::unique_ptr<PollingData_> PollingData_::fromString(const std::string &body, JsonArena &arena) {
         auto data = new PollingData_();
         auto dataPtr = std::unique_ptr<PollingData_>(data);
 
@@ -200,42 +554,9 @@ namespace ddi {
         data->sleepTime = -1;
         data->action = Actions_::NONE;
 
-        // try to get sleepTime:
-        std::string sleepTimeString;
-        if (document.HasMember("config")) {
-            const rapidjson::Value &config = document["config"];
-            if (config.HasMember("polling")) {
-                const rapidjson::Value &polling = config["polling"];
-                if (polling.HasMember("sleep")) {
-                    sleepTimeString = polling["sleep"].GetString();
-                }
-            }
-        }
-        if (!sleepTimeString.empty()) {
-            int hh, mm, ss;
-            if (sscanf(sleepTimeString.c_str(), "%d:%d:%d", &hh, &mm, &ss) != 3) {
-                throw unexpected_payload();
-            }
-            data->sleepTime = (hh * 3600 + mm * 60 + ss) * 1000;
-        }
-
-        if (!document.HasMember("_links")) {
-            return dataPtr;
-        }
-
-        const rapidjson::Value &links = document["_links"];
-        // there`re 3 variants of actions: configData, deploymentBase, cancelAction
-        // priority: configData, (cancelAction/deploymentBase)
-        if (links.HasMember("configData")) {
-            data->action = Actions_::GET_CONFIG_DATA;
-            data->followURI = parseHrefObject(links["configData"]);
-        } else if (links.HasMember("cancelAction")) {
-            data->action = Actions_::CANCEL_ACTION;
-            data->followURI = parseHrefObject(links["cancelAction"]);
-        } else if (links.HasMember("deploymentBase")) {
-            data->action = Actions_::DEPLOYMENT_BASE;
-            data->followURI = parseHrefObject(links["deploymentBase"]);
-        }
+        PollingDataReader reader(*data);
+        reader.parse(body, arena);
+        reader.finish();
 
         return dataPtr;
     }
@@ -0,0 +1,107 @@
+#include <utility>
+
+#include "action_context_impl.hpp"
+#include "ddi/hawkbit_exceptions.hpp"
+
+namespace ddi {
+
+    void AsyncActions::setWakeUp(std::function<void()> function) {
+        std::lock_guard<std::mutex> lock(mutex);
+        wakeUp = std::move(function);
+    }
+
+    std::shared_ptr<ActionState> AsyncActions::start(int actionId, std::shared_ptr<CancellationToken> cancellation) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto state = std::make_shared<ActionState>();
+        state->cancellation = std::move(cancellation);
+        active[actionId] = state;
+        return state;
+    }
+
+    bool AsyncActions::isActive(int actionId) {
+        std::lock_guard<std::mutex> lock(mutex);
+        return active.count(actionId) != 0;
+    }
+
+    void AsyncActions::cancel(int actionId) {
+        std::shared_ptr<CancellationToken> cancellation;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto found = active.find(actionId);
+            if (found == active.end()) {
+                return;
+            }
+            cancellation = found->second->cancellation;
+        }
+        // interrupts blocked downloads, so it is done without lock
+        cancellation->cancel();
+    }
+
+    void AsyncActions::finish(int actionId) {
+        std::lock_guard<std::mutex> lock(mutex);
+        active.erase(actionId);
+    }
+
+    void AsyncActions::push(const uri::URI &actionURI, int actionId, std::unique_ptr<Response> response) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto found = active.find(actionId);
+        if (found == active.end() || found->second->closing) {
+            return;
+        }
+        found->second->closing = isFinalExecution(response->getExecution());
+        queue.push_back({actionURI, actionId, std::move(response)});
+        if (wakeUp) {
+            wakeUp();
+        }
+    }
+
+    QueuedFeedback *AsyncActions::front() {
+        std::lock_guard<std::mutex> lock(mutex);
+        // deque keeps references valid when other elements are pushed
+        return queue.empty() ? nullptr : &queue.front();
+    }
+
+    void AsyncActions::pop() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (queue.empty()) {
+            return;
+        }
+        if (isFinalExecution(queue.front().response->getExecution())) {
+            active.erase(queue.front().actionId);
+        }
+        queue.pop_front();
+    }
+
+    bool isFinalExecution(Response::Execution execution) {
+        return execution == Response::CLOSED || execution == Response::CANCELED || execution == Response::REJECTED;
+    }
+
+    ActionContext_::ActionContext_(std::shared_ptr<AsyncActions> actions_, std::shared_ptr<ActionState> state_,
+                                   uri::URI actionURI_, int actionId_)
+            : actions(std::move(actions_)), state(std::move(state_)), actionURI(std::move(actionURI_)),
+              actionId(actionId_) {}
+
+    int ActionContext_::getActionId() {
+        return actionId;
+    }
+
+    void ActionContext_::sendFeedback(std::unique_ptr<Response> response) {
+        if (response == nullptr) {
+            throw wrong_response();
+        }
+        actions->push(actionURI, actionId, std::move(response));
+    }
+
+    std::future<void> ActionContext_::downloadTo(std::shared_ptr<Artifact> artifact, const std::string &path,
+                                                 int verify) {
+        // artifact keeps deployment storage alive till download is finished
+        return std::async(std::launch::async, [artifact, path, verify]() {
+            artifact->downloadTo(path, verify);
+        });
+    }
+
+    bool ActionContext_::isCanceled() {
+        return state->cancellation->isCanceled();
+    }
+
+}
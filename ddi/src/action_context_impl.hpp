@@ -0,0 +1,85 @@
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+
+#include "uriparse.hpp"
+#include "cancellation_token.hpp"
+#include "ddi/hawkbit_action_context.hpp"
+
+namespace ddi {
+
+    // feedback of asynchronous action waiting to be sent by polling thread
+    struct QueuedFeedback {
+        uri::URI actionURI;
+        int actionId;
+        std::unique_ptr<Response> response;
+    };
+
+    // state of async action shared with its context
+    struct ActionState {
+        // canceled by cancelAction, aborts downloads of deployment
+        std::shared_ptr<CancellationToken> cancellation;
+        // final feedback is queued, next feedback is ignored. Guarded by AsyncActions
+        bool closing = false;
+    };
+
+    // Deployments of one client that are finished in background (see ActionContext). Shared by client and contexts,
+    //  so context given to handler stays valid after client is destroyed.
+    class AsyncActions {
+    public:
+        // called when feedback is queued, should wake up polling thread. Called under lock
+        void setWakeUp(std::function<void()>);
+
+        // register action before it is passed to handler
+        std::shared_ptr<ActionState> start(int actionId, std::shared_ptr<CancellationToken>);
+
+        bool isActive(int actionId);
+
+        // abort downloads of action
+        void cancel(int actionId);
+
+        // remove action, its feedback is not queued anymore
+        void finish(int actionId);
+
+        // feedback of not active (or already finished) action is ignored
+        void push(const uri::URI &actionURI, int actionId, std::unique_ptr<Response>);
+
+        // oldest queued feedback or nullptr. Pointer is valid till pop(), only polling thread should take it
+        QueuedFeedback *front();
+
+        // remove oldest queued feedback. If it was final, action is finished
+        void pop();
+
+    private:
+        std::mutex mutex;
+        std::map<int, std::shared_ptr<ActionState>> active;
+        std::deque<QueuedFeedback> queue;
+        std::function<void()> wakeUp;
+    };
+
+    // CLOSED, CANCELED and REJECTED finish action
+    bool isFinalExecution(Response::Execution);
+
+    class ActionContext_ : public ActionContext {
+        std::shared_ptr<AsyncActions> actions;
+        std::shared_ptr<ActionState> state;
+        uri::URI actionURI;
+        int actionId;
+
+    public:
+        ActionContext_(std::shared_ptr<AsyncActions>, std::shared_ptr<ActionState>, uri::URI actionURI, int actionId);
+
+        int getActionId() override;
+
+        void sendFeedback(std::unique_ptr<Response>) override;
+
+        std::future<void> downloadTo(std::shared_ptr<Artifact>, const std::string &path, int verify) override;
+
+        bool isCanceled() override;
+    };
+
+}
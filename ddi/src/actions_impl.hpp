@@ -4,6 +4,8 @@
 #include "ddi/hawkbit_actions.hpp"
 #include "uriparse.hpp"
 #include "httplib.h"
+#include "json_arena.hpp"
+#include "cancellation_token.hpp"
 
 namespace ddi {
     // Define actions from hawkBit
@@ -22,12 +24,14 @@ namespace ddi {
 
         uri::URI getFollowURI();
 
-        static std::unique_ptr<PollingData_> fromString(const std::string &);
+        static std::unique_ptr<PollingData_> fromString(const std::string &, JsonArena &);
 
     private:
         int sleepTime;
         Actions_ action;
         uri::URI followURI;
+
+        friend class PollingDataReader;
     };
 
 
@@ -37,52 +41,49 @@ namespace ddi {
         int id;
         int stopId;
 
+        friend class CancelActionReader;
+
     public:
 
         int getId() override;
 
         int getStopId() override;
 
-        static std::unique_ptr<CancelAction> fromString(const std::string &);
+        static std::unique_ptr<CancelAction> fromString(const std::string &, JsonArena &);
+    };
+
+    class HashVerifier;
+
+    // artifact download parameters
+    struct DownloadRequest {
+        uri::URI uri;
+        // expected size in bytes, -1 if unknown
+        long long size = -1;
+        // every received block is passed to verifier. Can be nullptr
+        HashVerifier *verifier = nullptr;
+        // called with count of received bytes (negative if received data is dropped). Can be empty
+        std::function<void(long long)> onProgress;
+        // artifact content key in local cache, empty if unknown
+        std::string sha256;
+        // download is aborted with download_canceled when token is canceled. Can be nullptr
+        CancellationToken *cancellation = nullptr;
     };
 
     // used for get httpClient and its Headers
     class DownloadProvider {
     public:
-        virtual void downloadTo(uri::URI, const std::string &) = 0;
+        virtual void downloadTo(const DownloadRequest &, const std::string &) = 0;
 
         // get file as string
         virtual std::string getBody(uri::URI) = 0;
 
         // get file with defined Receiver. Return true from function to continue
         //  false to stop request
-        virtual void downloadWithReceiver(uri::URI uri, std::function<bool(const char *data, size_t data_length)>) = 0;
+        virtual void downloadWithReceiver(const DownloadRequest &,
+                                          std::function<bool(const char *data, size_t data_length)>) = 0;
     };
 
-    // internal DeploymentBase implementation
-    class DeploymentBase_ : public DeploymentBase {
-    public:
-
-        int getId() override;
-
-        std::string getDownloadType() override;
-
-        std::string getUpdateType() override;
-
-        bool isInMaintenanceWindow() override;
-
-        std::vector<std::shared_ptr<Chunk>> getChunks() override;
-
-        static std::unique_ptr<DeploymentBase> from(const std::string &, DownloadProvider *);
-
-    private:
-        int id;
-        std::string downloadType;
-        std::string updateType;
-        bool inMaintenanceWindow;
-        std::vector<std::shared_ptr<Chunk>> chunks;
-
-    };
+    struct DeploymentStorage;
 
     class Chunk_ : public Chunk {
     public:
@@ -95,13 +96,21 @@ namespace ddi {
 
         std::vector<std::shared_ptr<Artifact>> getArtifacts() override;
 
+        size_t artifactsCount() override;
+
+        Artifact &artifactAt(size_t index) override;
+
     private:
         std::string part;
         std::string version;
         std::string name;
-        std::vector<std::shared_ptr<Artifact>> artifacts;
+        // artifacts of chunk are stored in storage->artifacts[artifactsBegin, artifactsEnd)
+        DeploymentStorage *storage = nullptr;
+        size_t artifactsBegin = 0;
+        size_t artifactsEnd = 0;
 
         friend class DeploymentBase_;
+        friend class DeploymentBaseReader;
     };
 
     class Artifact_ : public Artifact {
@@ -109,24 +118,85 @@ namespace ddi {
 
         void downloadTo(std::string path) override;
 
+        void downloadTo(std::string path, int verify) override;
+
         std::string getBody() override;
 
         void downloadWithReceiver(std::function<bool(const char *, size_t)> function) override;
 
+        void downloadWithReceiver(std::function<bool(const char *, size_t)> function, int verify) override;
+
         std::string getFilename() override;
 
+        const std::string &getFilenameRef() override;
+
         Hashes getFileHashes() override;
 
+        const Hashes &getFileHashesRef() override;
+
         int size() override;
 
+        // download with verification and progress reporting
+        void downloadTo(const std::string &path, int verify, const std::function<void(long long)> &onProgress);
+
     private:
+        DownloadRequest newDownloadRequest(HashVerifier *);
+
         std::string filename;
         Hashes fileHash;
         int fileSize;
         uri::URI downloadURI;
         DownloadProvider *downloadProvider;
+        // owned by deployment storage
+        CancellationToken *cancellation = nullptr;
 
         friend class DeploymentBase_;
+        friend class DeploymentBaseReader;
+    };
+
+    // All chunks and artifacts of deployment in two flat arrays (one allocation per array instead of
+    //  one per object). shared_ptr to chunk/artifact shares ownership of the whole storage.
+    struct DeploymentStorage : public std::enable_shared_from_this<DeploymentStorage> {
+        std::vector<Chunk_> chunks;
+        std::vector<Artifact_> artifacts;
+        // aborts downloads of deployment artifacts
+        std::shared_ptr<CancellationToken> cancellation = std::make_shared<CancellationToken>();
+    };
+
+    // internal DeploymentBase implementation
+    class DeploymentBase_ : public DeploymentBase {
+    public:
+
+        int getId() override;
+
+        std::string getDownloadType() override;
+
+        std::string getUpdateType() override;
+
+        bool isInMaintenanceWindow() override;
+
+        std::vector<std::shared_ptr<Chunk>> getChunks() override;
+
+        size_t chunksCount() override;
+
+        Chunk &chunkAt(size_t index) override;
+
+        std::vector<ArtifactDownloadResult> downloadAll(const std::string &dir,
+                                                        const DownloadOptions &options) override;
+
+        static std::unique_ptr<DeploymentBase> from(const std::string &, DownloadProvider *, JsonArena &);
+
+        // token that aborts downloads of this deployment
+        std::shared_ptr<CancellationToken> getCancellation();
+
+    private:
+        int id;
+        std::string downloadType;
+        std::string updateType;
+        bool inMaintenanceWindow;
+        std::shared_ptr<DeploymentStorage> storage = std::make_shared<DeploymentStorage>();
+
+        friend class DeploymentBaseReader;
     };
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,264 @@
+#include <cctype>
+#include <cstdio>
+#include <sstream>
+#include <vector>
+
+#include <sys/stat.h>
+
+#include "artifact_cache.hpp"
+#include "utils.hpp"
+#include "ddi/hawkbit_exceptions.hpp"
+
+namespace ddi {
+
+    const char *ARTIFACT_CACHE_INDEX = "index";
+
+    const size_t ARTIFACT_CACHE_BLOCK_SIZE = 64 * 1024;
+
+    // key comes from the server and is used as file name, so only sha256 hex digest is accepted
+    bool isValidCacheKey(const std::string &sha256) {
+        if (sha256.size() != 64) {
+            return false;
+        }
+        for (auto c: sha256) {
+            if (!std::isxdigit((unsigned char) c)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    std::string cacheKeyFrom(const std::string &sha256) {
+        std::string key = sha256;
+        for (auto &c: key) {
+            c = (char) std::tolower((unsigned char) c);
+        }
+        return key;
+    }
+
+    Hashes sha256Hashes(const std::string &sha256) {
+        Hashes hashes;
+        hashes.sha256 = sha256;
+        return hashes;
+    }
+
+    ArtifactCache::Writer::Writer(ArtifactCache *cache_, const std::string &sha256_, const std::string &tmpPath_)
+            : cache(cache_), sha256(sha256_), tmpPath(tmpPath_), file(tmpPath_, std::ios::binary | std::ios::trunc),
+              verifier(sha256Hashes(sha256_), VERIFY_SHA256) {}
+
+    void ArtifactCache::Writer::write(const char *data, size_t size) {
+        verifier.update(data, size);
+        file.write(data, size);
+        written += (long long) size;
+    }
+
+    bool ArtifactCache::Writer::commit() {
+        file.close();
+        if (file.fail()) {
+            return false;
+        }
+        try {
+            verifier.verify();
+        } catch (artifact_verification_error &) {
+            return false;
+        }
+        committed = cache->add(sha256, tmpPath, written);
+        return committed;
+    }
+
+    ArtifactCache::Writer::~Writer() {
+        if (!committed) {
+            file.close();
+            std::remove(tmpPath.c_str());
+        }
+    }
+
+    ArtifactCache::ArtifactCache(const std::string &dir_, long long maxSize_) : dir(dir_), maxSize(maxSize_) {
+        if (!dir.empty() && dir.back() == '/') {
+            dir.pop_back();
+        }
+        createDirectory(dir);
+        loadIndex();
+    }
+
+    ArtifactCache::~ArtifactCache() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (indexChanged) {
+            saveIndex();
+        }
+    }
+
+    std::string ArtifactCache::pathOf(const std::string &sha256) const {
+        return dir + "/" + sha256;
+    }
+
+    bool ArtifactCache::read(const std::string &sha256_, const std::function<bool(const char *, size_t)> &receiver) {
+        if (!isValidCacheKey(sha256_)) {
+            return false;
+        }
+        auto sha256 = cacheKeyFrom(sha256_);
+        long long size;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto found = entries.find(sha256);
+            if (found == entries.end()) {
+                return false;
+            }
+            size = found->second.size;
+        }
+
+        // file is opened once, so it stays readable even if entry is evicted meanwhile
+        std::ifstream file(pathOf(sha256), std::ios::binary);
+        std::vector<char> buf(ARTIFACT_CACHE_BLOCK_SIZE);
+        HashVerifier verifier(sha256Hashes(sha256), VERIFY_SHA256);
+        long long read = 0;
+        while (file.read(buf.data(), (std::streamsize) buf.size()) || file.gcount() > 0) {
+            verifier.update(buf.data(), (size_t) file.gcount());
+            read += file.gcount();
+        }
+        try {
+            if (!file.eof() || read != size) {
+                throw artifact_verification_error(VERIFY_SHA256);
+            }
+            verifier.verify();
+        } catch (artifact_verification_error &) {
+            // file is damaged or changed outside
+            drop(sha256);
+            return false;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto found = entries.find(sha256);
+            if (found != entries.end()) {
+                found->second.lastUsed = ++usageCounter;
+                indexChanged = true;
+            }
+        }
+
+        file.clear();
+        file.seekg(0);
+        while (file.read(buf.data(), (std::streamsize) buf.size()) || file.gcount() > 0) {
+            if (!receiver(buf.data(), (size_t) file.gcount())) {
+                break;
+            }
+        }
+        return true;
+    }
+
+    std::unique_ptr<ArtifactCache::Writer> ArtifactCache::newEntry(const std::string &sha256) {
+        if (!isValidCacheKey(sha256)) {
+            return nullptr;
+        }
+        auto key = cacheKeyFrom(sha256);
+        auto tmpPath = pathOf(key) + ".tmp" + std::to_string(tmpCounter++);
+        return std::unique_ptr<Writer>(new Writer(this, key, tmpPath));
+    }
+
+    bool ArtifactCache::store(const std::string &sha256, const std::string &path) {
+        auto entry = newEntry(sha256);
+        if (!entry) {
+            return false;
+        }
+        std::ifstream file(path, std::ios::binary);
+        std::vector<char> buf(ARTIFACT_CACHE_BLOCK_SIZE);
+        while (file.read(buf.data(), (std::streamsize) buf.size()) || file.gcount() > 0) {
+            entry->write(buf.data(), (size_t) file.gcount());
+        }
+        if (!file.eof()) {
+            return false;
+        }
+        return entry->commit();
+    }
+
+    bool ArtifactCache::add(const std::string &sha256, const std::string &tmpPath, long long size) {
+        if (maxSize > 0 && size > maxSize) {
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!replaceFile(tmpPath, pathOf(sha256))) {
+            return false;
+        }
+        auto found = entries.find(sha256);
+        if (found != entries.end()) {
+            totalSize -= found->second.size;
+        }
+        entries[sha256] = {size, ++usageCounter};
+        totalSize += size;
+        evict();
+        saveIndex();
+        return true;
+    }
+
+    void ArtifactCache::drop(const std::string &sha256) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto found = entries.find(sha256);
+        if (found == entries.end()) {
+            return;
+        }
+        totalSize -= found->second.size;
+        entries.erase(found);
+        std::remove(pathOf(sha256).c_str());
+        saveIndex();
+    }
+
+    void ArtifactCache::evict() {
+        while (maxSize > 0 && totalSize > maxSize && !entries.empty()) {
+            auto lru = entries.begin();
+            for (auto it = entries.begin(); it != entries.end(); ++it) {
+                if (it->second.lastUsed < lru->second.lastUsed) {
+                    lru = it;
+                }
+            }
+            totalSize -= lru->second.size;
+            std::remove(pathOf(lru->first).c_str());
+            entries.erase(lru);
+        }
+    }
+
+    void ArtifactCache::loadIndex() {
+        std::ifstream index(dir + "/" + ARTIFACT_CACHE_INDEX);
+        std::string line;
+        while (std::getline(index, line)) {
+            std::istringstream fields(line);
+            std::string sha256;
+            Entry entry{};
+            if (!(fields >> sha256 >> entry.size >> entry.lastUsed) || !isValidCacheKey(sha256)) {
+                continue;
+            }
+            // entry is kept only if file is still in place
+            struct stat st{};
+            if (stat(pathOf(sha256).c_str(), &st) != 0 || (long long) st.st_size != entry.size) {
+                continue;
+            }
+            entries[sha256] = entry;
+            totalSize += entry.size;
+            if (entry.lastUsed > usageCounter) {
+                usageCounter = entry.lastUsed;
+            }
+        }
+
+        // limit could be decreased since last run
+        std::lock_guard<std::mutex> lock(mutex);
+        evict();
+        saveIndex();
+    }
+
+    void ArtifactCache::saveIndex() {
+        auto indexPath = dir + "/" + ARTIFACT_CACHE_INDEX;
+        auto tmpPath = indexPath + ".tmp";
+        {
+            std::ofstream index(tmpPath, std::ios::trunc);
+            for (const auto &entry: entries) {
+                index << entry.first << ' ' << entry.second.size << ' ' << entry.second.lastUsed << '\n';
+            }
+            if (index.fail()) {
+                return;
+            }
+        }
+        if (replaceFile(tmpPath, indexPath)) {
+            indexChanged = false;
+        }
+    }
+
+}
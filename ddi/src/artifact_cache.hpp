@@ -0,0 +1,92 @@
+#pragma once
+
+#include <atomic>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "hash_verifier.hpp"
+
+namespace ddi {
+
+    // Content-addressed on-disk storage of downloaded artifacts. Files are stored as <dir>/<sha256>,
+    //  index file keeps size and last usage of every entry, least recently used entries are evicted
+    //  when summary size exceeds the limit. All operations are best-effort: cache errors never fail download.
+    // Index is saved when entries are added or removed and on destruction. Usage updated by read() alone
+    //  is lost on crash, which only affects eviction order.
+    class ArtifactCache {
+    public:
+        // Entry being filled from the network. Becomes visible in the cache only after successful commit.
+        class Writer {
+            ArtifactCache *cache;
+            std::string sha256;
+            std::string tmpPath;
+            std::ofstream file;
+            HashVerifier verifier;
+            long long written = 0;
+            bool committed = false;
+
+            friend class ArtifactCache;
+
+        public:
+            Writer(ArtifactCache *cache_, const std::string &sha256_, const std::string &tmpPath_);
+
+            void write(const char *data, size_t size);
+
+            // file content is checked against sha256, broken entry is dropped. Returns true if entry is stored
+            bool commit();
+
+            ~Writer();
+        };
+
+        // maxSize - max summary size of cached files in bytes, 0 - unlimited
+        ArtifactCache(const std::string &dir, long long maxSize);
+
+        // pass cached file to receiver. File content is checked against sha256 before the first block is passed.
+        //  Returns false if there is no valid entry for sha256
+        bool read(const std::string &sha256, const std::function<bool(const char *, size_t)> &receiver);
+
+        std::unique_ptr<Writer> newEntry(const std::string &sha256);
+
+        // copy already downloaded file into the cache
+        bool store(const std::string &sha256, const std::string &path);
+
+        ~ArtifactCache();
+
+    private:
+        struct Entry {
+            long long size;
+            unsigned long long lastUsed;
+        };
+
+        std::string dir;
+        long long maxSize;
+
+        std::mutex mutex;
+        std::map<std::string, Entry> entries;
+        long long totalSize = 0;
+        unsigned long long usageCounter = 0;
+        // usage changed since index was saved
+        bool indexChanged = false;
+        std::atomic<unsigned long> tmpCounter{0};
+
+        std::string pathOf(const std::string &sha256) const;
+
+        // takes ownership of verified tmp file
+        bool add(const std::string &sha256, const std::string &tmpPath, long long size);
+
+        void drop(const std::string &sha256);
+
+        // should be called under lock
+        void evict();
+
+        void loadIndex();
+
+        // should be called under lock
+        void saveIndex();
+    };
+
+}
@@ -0,0 +1,47 @@
+#include <utility>
+
+#include "cancellation_token.hpp"
+
+namespace ddi {
+
+    CancellationToken::Subscription::Subscription(CancellationToken *token_, std::function<void()> callback)
+            : token(token_) {
+        if (token == nullptr) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(token->mutex);
+        if (token->canceled) {
+            callback();
+        }
+        id = token->nextId++;
+        token->callbacks.emplace(id, std::move(callback));
+    }
+
+    CancellationToken::Subscription::~Subscription() {
+        if (token == nullptr) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(token->mutex);
+        token->callbacks.erase(id);
+    }
+
+    void CancellationToken::cancel() {
+        // callbacks are called under lock, so subscriber cannot be destroyed meanwhile
+        std::lock_guard<std::mutex> lock(mutex);
+        if (canceled.exchange(true)) {
+            return;
+        }
+        for (auto &callback: callbacks) {
+            callback.second();
+        }
+    }
+
+    bool CancellationToken::isCanceled() const {
+        return canceled;
+    }
+
+    bool isCanceled(const CancellationToken *token) {
+        return token != nullptr && token->isCanceled();
+    }
+
+}
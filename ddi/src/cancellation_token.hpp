@@ -0,0 +1,45 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <mutex>
+
+namespace ddi {
+
+    // Cancel flag of deployment downloads. Running download checks the flag on every received block,
+    //  blocking operations (socket read, wait before retry) subscribe callbacks to be interrupted.
+    class CancellationToken {
+    public:
+        // Callback is called by cancel() while subscription exists (at once if token is already canceled).
+        //  Callback is not running after subscription is destroyed. Token can be nullptr (never canceled)
+        class Subscription {
+            CancellationToken *token;
+            size_t id = 0;
+
+        public:
+            Subscription(CancellationToken *token, std::function<void()> callback);
+
+            Subscription(const Subscription &) = delete;
+
+            Subscription &operator=(const Subscription &) = delete;
+
+            ~Subscription();
+        };
+
+        // set flag and call subscribed callbacks
+        void cancel();
+
+        bool isCanceled() const;
+
+    private:
+        std::atomic<bool> canceled{false};
+        std::mutex mutex;
+        size_t nextId = 0;
+        std::map<size_t, std::function<void()>> callbacks;
+    };
+
+    // token can be nullptr
+    bool isCanceled(const CancellationToken *);
+
+}
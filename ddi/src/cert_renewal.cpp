@@ -0,0 +1,104 @@
+#include <algorithm>
+#include <utility>
+
+#include "cert_renewal.hpp"
+
+namespace ddi {
+
+    // delay before the next attempt if renewal failed or set no credentials
+    const std::chrono::seconds CERT_RENEWAL_RETRY_DELAY(60);
+
+    CertificateRenewal::CertificateRenewal(double lifetimeFraction_, Renew renew_)
+            : lifetimeFraction(lifetimeFraction_), renew(std::move(renew_)) {
+        thread = std::thread(&CertificateRenewal::run, this);
+    }
+
+    CertificateRenewal::~CertificateRenewal() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopRequested = true;
+            changed.notify_all();
+        }
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+
+    void CertificateRenewal::schedule(X509 *certificate) {
+        auto time = certificate == nullptr ? Clock::time_point::max() : renewalTime(certificate, lifetimeFraction);
+        auto certificateNotAfter = notAfterOf(certificate);
+        std::lock_guard<std::mutex> lock(mutex);
+        deadline = time;
+        notAfter = std::move(certificateNotAfter);
+        changed.notify_all();
+    }
+
+    void CertificateRenewal::run() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (!stopRequested) {
+            if (deadline == Clock::time_point::max()) {
+                changed.wait(lock);
+                continue;
+            }
+            // renewal time of certificate can be already passed, so attempts are limited here
+            auto attemptTime = deadline;
+            if (lastAttempt != Clock::time_point::min()) {
+                attemptTime = std::max(attemptTime, lastAttempt + CERT_RENEWAL_RETRY_DELAY);
+            }
+            if (Clock::now() < attemptTime) {
+                changed.wait_until(lock, attemptTime);
+                continue;
+            }
+
+            // new certificate schedules the next renewal when it's set
+            deadline = Clock::time_point::max();
+            lastAttempt = Clock::now();
+            auto renewedNotAfter = notAfter;
+            lock.unlock();
+
+            bool renewed = false;
+            try {
+                renewed = renew();
+            } catch (...) {
+                // retried later, expired certificate is also renewed on HTTP_UNAUTHORIZED
+            }
+
+            lock.lock();
+            if (!notAfter.empty() && notAfter == renewedNotAfter) {
+                // no new certificate: nothing was set or the handler returned the same one
+                renewed = false;
+            }
+            if (!renewed && deadline == Clock::time_point::max()) {
+                deadline = lastAttempt + CERT_RENEWAL_RETRY_DELAY;
+            }
+        }
+    }
+
+    CertificateRenewal::Clock::time_point CertificateRenewal::renewalTime(X509 *certificate, double lifetimeFraction) {
+        int days, seconds;
+        // nullptr is the current time
+        if (!ASN1_TIME_diff(&days, &seconds, X509_get0_notBefore(certificate), nullptr)) {
+            return Clock::time_point::max();
+        }
+        auto elapsed = (long long) days * 24 * 60 * 60 + seconds;
+        if (!ASN1_TIME_diff(&days, &seconds, nullptr, X509_get0_notAfter(certificate))) {
+            return Clock::time_point::max();
+        }
+        auto lifetime = elapsed + (long long) days * 24 * 60 * 60 + seconds;
+        if (lifetime <= 0) {
+            return Clock::time_point::max();
+        }
+
+        auto untilRenewal = std::max(0LL, (long long) ((double) lifetime * lifetimeFraction) - elapsed);
+        return Clock::now() + std::chrono::seconds(untilRenewal);
+    }
+
+    std::string CertificateRenewal::notAfterOf(X509 *certificate) {
+        if (certificate == nullptr) {
+            return {};
+        }
+        auto time = X509_get0_notAfter(certificate);
+        return std::string((const char *) ASN1_STRING_get0_data(time), (size_t) ASN1_STRING_length(time));
+    }
+
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <openssl/x509.h>
+
+namespace ddi {
+
+    // Renews mTLS certificate before it expires. When the given fraction of certificate lifetime (notBefore..notAfter)
+    //  passed, renew function is called from background thread, so polling is not stopped while the new certificate
+    //  is issued. New certificate should be passed to schedule() to plan the next renewal.
+    // Attempts are at least CERT_RENEWAL_RETRY_DELAY apart. Renewal which kept notAfter of certificate
+    //  (ex. the same certificate is returned) is failed and retried after the same delay.
+    class CertificateRenewal {
+    public:
+        using Clock = std::chrono::steady_clock;
+        // returns false if no credentials were set (renewal is retried later)
+        using Renew = std::function<bool()>;
+
+        CertificateRenewal(double lifetimeFraction, Renew renew);
+
+        // schedule renewal of certificate, previous schedule is dropped. nullptr (token auth) cancels renewal
+        void schedule(X509 *certificate);
+
+        ~CertificateRenewal();
+
+        // Clock::time_point::max() if validity of certificate cannot be read
+        static Clock::time_point renewalTime(X509 *, double lifetimeFraction);
+
+        // raw notAfter of certificate, empty for nullptr
+        static std::string notAfterOf(X509 *);
+
+    private:
+        double lifetimeFraction;
+        Renew renew;
+
+        std::mutex mutex;
+        std::condition_variable changed;
+        Clock::time_point deadline = Clock::time_point::max();
+        std::string notAfter;
+        Clock::time_point lastAttempt = Clock::time_point::min();
+        bool stopRequested = false;
+
+        std::thread thread;
+
+        void run();
+    };
+
+}
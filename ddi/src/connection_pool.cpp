@@ -0,0 +1,100 @@
+#include <iterator>
+#include <utility>
+
+#include "connection_pool.hpp"
+
+namespace ddi {
+
+    std::string poolKeyFrom(uri::URI &uri) {
+        return uri.getScheme() + "://" + uri.getAuthority();
+    }
+
+    ConnectionPool::Lease::~Lease() {
+        if (pool != nullptr && client && reusable) {
+            pool->release(*this);
+        }
+    }
+
+    ConnectionPool::ConnectionPool(int idleTimeout_) : idleTimeout(idleTimeout_) {}
+
+    ConnectionPool::Lease ConnectionPool::acquire(uri::URI &uri, const std::shared_ptr<TLSContext> &tlsContext,
+                                                  const ClientFactory &factory) {
+        Lease lease;
+        lease.pool = this;
+        lease.key = poolKeyFrom(uri);
+        lease.tlsContext = tlsContext;
+
+        // expired clients are destroyed out of the lock (closing TLS connection can take a while)
+        std::vector<IdleClient> expired;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto now = std::chrono::steady_clock::now();
+            for (auto entry = idle.begin(); entry != idle.end();) {
+                auto &clients = entry->second;
+                for (auto it = clients.begin(); it != clients.end();) {
+                    if (now - it->lastUsed > idleTimeout) {
+                        expired.push_back(std::move(*it));
+                        it = clients.erase(it);
+                    } else {
+                        ++it;
+                    }
+                }
+                // authorities used once (ex. download servers) are not kept
+                entry = clients.empty() ? idle.erase(entry) : std::next(entry);
+            }
+
+            lease.generation = generation;
+            auto found = idle.find(lease.key);
+            if (found != idle.end()) {
+                auto &clients = found->second;
+                // most recently used connection is most likely still alive
+                for (auto it = clients.rbegin(); it != clients.rend(); ++it) {
+                    if (it->tlsContext == tlsContext) {
+                        lease.client = std::move(it->client);
+                        clients.erase(std::next(it).base());
+                        if (clients.empty()) {
+                            idle.erase(found);
+                        }
+                        return lease;
+                    }
+                }
+            }
+        }
+
+        lease.client = factory(uri);
+        return lease;
+    }
+
+    void ConnectionPool::release(Lease &lease) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (lease.generation != generation || maxIdlePerAuthority == 0) {
+            // lease destroys client after lock is released
+            return;
+        }
+        auto found = idle.find(lease.key);
+        if (found != idle.end() && found->second.size() >= maxIdlePerAuthority) {
+            return;
+        }
+        // entry is created only for kept client
+        auto &clients = found != idle.end() ? found->second : idle[lease.key];
+        clients.push_back({std::move(lease.tlsContext), std::move(lease.client), std::chrono::steady_clock::now()});
+    }
+
+    void ConnectionPool::invalidate() {
+        std::map<std::string, std::vector<IdleClient>> dropped;
+        std::lock_guard<std::mutex> lock(mutex);
+        generation++;
+        dropped.swap(idle);
+    }
+
+    void ConnectionPool::setIdleTimeout(int idleTimeout_) {
+        std::lock_guard<std::mutex> lock(mutex);
+        idleTimeout = std::chrono::milliseconds(idleTimeout_);
+    }
+
+    void ConnectionPool::setMaxIdlePerAuthority(size_t maxIdle_) {
+        std::lock_guard<std::mutex> lock(mutex);
+        maxIdlePerAuthority = maxIdle_;
+    }
+
+}
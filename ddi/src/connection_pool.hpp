@@ -0,0 +1,90 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "httplib.h"
+#include "uriparse.hpp"
+#include "tls_context.hpp"
+
+namespace ddi {
+
+    // default time after which idle keep-alive connection will be closed (ms)
+    const int DEFAULT_CONNECTION_IDLE_TIMEOUT = 60000;
+
+    // default max idle connections stored for one authority
+    const size_t MAX_IDLE_CONNECTIONS_PER_AUTHORITY = 4;
+
+    // Pool of keep-alive httplib clients. Clients are grouped by authority (scheme://host:port),
+    //  so poll, feedback and download requests to the same server reuse already opened TCP/TLS connection.
+    //  Client is reused only with the TLS context it was created with, and keeps the context alive.
+    class ConnectionPool {
+    public:
+        // creates new httpClient for given URI if no idle one is available
+        using ClientFactory = std::function<std::unique_ptr<httplib::Client>(uri::URI &)>;
+
+        // Client borrowed from pool. Client returns to the pool when lease is destroyed.
+        class Lease {
+            ConnectionPool *pool = nullptr;
+            std::string key;
+            // declared before client, so SSL_CTX outlives connection
+            std::shared_ptr<TLSContext> tlsContext;
+            std::unique_ptr<httplib::Client> client;
+            unsigned long generation = 0;
+            bool reusable = true;
+
+            friend class ConnectionPool;
+
+        public:
+            Lease() = default;
+
+            Lease(Lease &&) noexcept = default;
+
+            Lease &operator=(Lease &&) noexcept = default;
+
+            httplib::Client &operator*() { return *client; }
+
+            httplib::Client *operator->() { return client.get(); }
+
+            // connection state is unknown (ex: request failed), do not return it to the pool
+            void discard() { reusable = false; }
+
+            ~Lease();
+        };
+
+        explicit ConnectionPool(int idleTimeout_ = DEFAULT_CONNECTION_IDLE_TIMEOUT);
+
+        // factory should create client with given TLS context
+        Lease acquire(uri::URI &, const std::shared_ptr<TLSContext> &, const ClientFactory &);
+
+        // close all idle connections and drop leased ones when they are returned.
+        //  Should be called when credentials are changed (connections of old TLS context are not used anymore).
+        void invalidate();
+
+        void setIdleTimeout(int idleTimeout_);
+
+        // should be not less than count of threads doing requests to the same server
+        void setMaxIdlePerAuthority(size_t maxIdle_);
+
+    private:
+        struct IdleClient {
+            std::shared_ptr<TLSContext> tlsContext;
+            std::unique_ptr<httplib::Client> client;
+            std::chrono::steady_clock::time_point lastUsed;
+        };
+
+        std::mutex mutex;
+        std::map<std::string, std::vector<IdleClient>> idle;
+        unsigned long generation = 0;
+        std::chrono::milliseconds idleTimeout;
+        size_t maxIdlePerAuthority = MAX_IDLE_CONNECTIONS_PER_AUTHORITY;
+
+        void release(Lease &);
+    };
+
+}
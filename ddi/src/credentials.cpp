@@ -0,0 +1,84 @@
+#include <utility>
+
+#include "credentials.hpp"
+#include "ddi_client_impl.hpp"
+#include "utils.hpp"
+
+namespace ddi {
+
+    CredentialsEditor::CredentialsEditor(Credentials credentials_) : credentials(std::move(credentials_)) {}
+
+    Credentials &CredentialsEditor::get() {
+        return credentials;
+    }
+
+    void CredentialsEditor::setTLS(const std::string &crt, const std::string &key) {
+        credentials.tlsContext = TLSContext::fromKeyPair(crt, key);
+        credentials.headers.erase(AUTHORIZATION_HEADER);
+    }
+
+    void CredentialsEditor::setEndpoint(const std::string &endpoint) {
+        credentials.hawkbitURI = uri::URI::fromString(endpoint);
+    }
+
+    void CredentialsEditor::setEndpoint(std::string &hawkbitEndpoint, const std::string &controllerId,
+                                        const std::string &tenant) {
+        setEndpoint(hawkbitEndpointFrom(hawkbitEndpoint, controllerId, tenant));
+    }
+
+    void CredentialsEditor::setDeviceToken(const std::string &token) {
+        credentials.headers.erase(AUTHORIZATION_HEADER);
+        credentials.headers.insert({AUTHORIZATION_HEADER, formatAuthHeader(TARGET_TOKEN_HEADER, token)});
+        if (!credentials.tlsContext || credentials.tlsContext->hasKeyPair()) {
+            credentials.tlsContext = TLSContext::create();
+        }
+    }
+
+    void CredentialsEditor::setGatewayToken(const std::string &token) {
+        credentials.headers.erase(AUTHORIZATION_HEADER);
+        credentials.headers.insert({AUTHORIZATION_HEADER, formatAuthHeader(GATEWAY_TOKEN_HEADER, token)});
+        if (!credentials.tlsContext || credentials.tlsContext->hasKeyPair()) {
+            credentials.tlsContext = TLSContext::create();
+        }
+    }
+
+    void CredentialsStaging::add(CredentialsUpdate update) {
+        std::lock_guard<std::mutex> lock(mutex);
+        updates.push_back(std::move(update));
+    }
+
+    std::vector<CredentialsUpdate> CredentialsStaging::take() {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto taken = std::move(updates);
+        updates.clear();
+        return taken;
+    }
+
+    StagingRestoreHandler::StagingRestoreHandler(std::shared_ptr<CredentialsStaging> staging_)
+            : staging(std::move(staging_)) {}
+
+    void StagingRestoreHandler::setTLS(const std::string &crt, const std::string &key) {
+        staging->add([crt, key](AuthRestoreHandler &cli) { cli.setTLS(crt, key); });
+    }
+
+    void StagingRestoreHandler::setEndpoint(const std::string &endpoint) {
+        staging->add([endpoint](AuthRestoreHandler &cli) { cli.setEndpoint(endpoint); });
+    }
+
+    void StagingRestoreHandler::setEndpoint(std::string &hawkbitEndpoint, const std::string &controllerId,
+                                            const std::string &tenant) {
+        staging->add([hawkbitEndpoint, controllerId, tenant](AuthRestoreHandler &cli) {
+            auto endpoint = hawkbitEndpoint;
+            cli.setEndpoint(endpoint, controllerId, tenant);
+        });
+    }
+
+    void StagingRestoreHandler::setDeviceToken(const std::string &token) {
+        staging->add([token](AuthRestoreHandler &cli) { cli.setDeviceToken(token); });
+    }
+
+    void StagingRestoreHandler::setGatewayToken(const std::string &token) {
+        staging->add([token](AuthRestoreHandler &cli) { cli.setGatewayToken(token); });
+    }
+
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "httplib.h"
+#include "uriparse.hpp"
+#include "tls_context.hpp"
+#include "ddi/ddi_client.hpp"
+
+namespace ddi {
+
+    // Endpoint and authorization of client requests. Snapshot is immutable: changed credentials are published
+    //  as a new snapshot, so every request uses consistent credentials taken when it was started.
+    struct Credentials {
+        uri::URI hawkbitURI;
+        // default headers (and Authorization header of token auth)
+        httplib::Headers headers;
+        // SSL_CTX of https connections (contains mTLS keypair if set)
+        std::shared_ptr<TLSContext> tlsContext;
+    };
+
+    // change of credentials made through AuthRestoreHandler
+    using CredentialsUpdate = std::function<void(AuthRestoreHandler &)>;
+
+    // applies AuthRestoreHandler calls to a copy of credentials
+    class CredentialsEditor : public AuthRestoreHandler {
+        Credentials credentials;
+    public:
+        explicit CredentialsEditor(Credentials credentials);
+
+        Credentials &get();
+
+        void setTLS(const std::string &crt, const std::string &key) override;
+
+        void setEndpoint(const std::string &endpoint) override;
+
+        void setEndpoint(std::string &hawkbitEndpoint, const std::string &controllerId,
+                         const std::string &tenant = "default") override;
+
+        void setDeviceToken(const std::string &token) override;
+
+        void setGatewayToken(const std::string &token) override;
+    };
+
+    // credentials set through StagingRestoreHandler, they are applied when AuthErrorHandler returns
+    class CredentialsStaging {
+    public:
+        void add(CredentialsUpdate);
+
+        // updates in order they were set
+        std::vector<CredentialsUpdate> take();
+
+    private:
+        std::mutex mutex;
+        std::vector<CredentialsUpdate> updates;
+    };
+
+    // AuthRestoreHandler passed to user AuthErrorHandler. Calls only record updates, so client state is not
+    //  changed from the thread the handler is called from
+    class StagingRestoreHandler : public AuthRestoreHandler {
+        std::shared_ptr<CredentialsStaging> staging;
+    public:
+        explicit StagingRestoreHandler(std::shared_ptr<CredentialsStaging>);
+
+        void setTLS(const std::string &crt, const std::string &key) override;
+
+        void setEndpoint(const std::string &endpoint) override;
+
+        void setEndpoint(std::string &hawkbitEndpoint, const std::string &controllerId,
+                         const std::string &tenant = "default") override;
+
+        void setDeviceToken(const std::string &token) override;
+
+        void setGatewayToken(const std::string &token) override;
+    };
+
+}
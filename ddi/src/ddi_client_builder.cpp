@@ -79,6 +79,92 @@ namespace ddi {
     }
 
 
+    DDIClientBuilder *DefaultClientBuilderImpl::setConnectionIdleTimeout(int idleTimeout) {
+        connectionIdleTimeout = idleTimeout;
+
+        return this;
+    }
+
+    DDIClientBuilder *DefaultClientBuilderImpl::setDownloadResumeAttempts(int attempts) {
+        downloadRetryPolicy.maxRetries = attempts;
+
+        return this;
+    }
+
+    DDIClientBuilder *DefaultClientBuilderImpl::setPollRetryPolicy(const RetryPolicy &policy) {
+        pollRetryPolicy = policy;
+
+        return this;
+    }
+
+    DDIClientBuilder *DefaultClientBuilderImpl::setPollErrorHandler(ClientErrorHandler errorHandler) {
+        pollErrorHandler = std::move(errorHandler);
+
+        return this;
+    }
+
+    DDIClientBuilder *DefaultClientBuilderImpl::setFeedbackRetryPolicy(const RetryPolicy &policy) {
+        feedbackRetryPolicy = policy;
+
+        return this;
+    }
+
+    DDIClientBuilder *DefaultClientBuilderImpl::setDownloadRetryPolicy(const RetryPolicy &policy) {
+        downloadRetryPolicy = policy;
+
+        return this;
+    }
+
+    DDIClientBuilder *DefaultClientBuilderImpl::setSegmentedDownload(long long segmentSize, int maxConnections) {
+        downloadSegmentSize = segmentSize;
+        downloadMaxConnections = maxConnections;
+
+        return this;
+    }
+
+    DDIClientBuilder *DefaultClientBuilderImpl::setPollingJitter(double ratio) {
+        pollingJitter = ratio;
+
+        return this;
+    }
+
+    DDIClientBuilder *DefaultClientBuilderImpl::setInitialSplay(int maxSplay) {
+        initialSplay = maxSplay;
+
+        return this;
+    }
+
+    DDIClientBuilder *DefaultClientBuilderImpl::setPollTriggerSocket(const std::string &path) {
+        pollTriggerSocket = path;
+
+        return this;
+    }
+
+    DDIClientBuilder *DefaultClientBuilderImpl::setArtifactCache(const std::string &dir, long long maxSize) {
+        artifactCacheDir = dir;
+        artifactCacheMaxSize = maxSize;
+
+        return this;
+    }
+
+    DDIClientBuilder *DefaultClientBuilderImpl::setAsyncDeployment() {
+        asyncDeployment = true;
+
+        return this;
+    }
+
+    DDIClientBuilder *DefaultClientBuilderImpl::setFeedbackOutbox(const std::string &dir) {
+        feedbackOutboxDir = dir;
+
+        return this;
+    }
+
+    DDIClientBuilder *DefaultClientBuilderImpl::setCertificateRenewal(double lifetimeFraction) {
+        certRenewalFraction = lifetimeFraction;
+
+        return this;
+    }
+
     DDIClientBuilder *DefaultClientBuilderImpl::setAuthErrorHandler(std::shared_ptr<AuthErrorHandler> e) {
         authErrorHandler = e;
 
@@ -89,15 +175,61 @@ namespace ddi {
         auto cli = new HawkbitCommunicationClient();
         auto cliPtr = std::unique_ptr<Client>(cli);
 
+        cli->credentials = std::make_shared<const Credentials>(Credentials{{}, defaultHeaders, TLSContext::create()});
         if (!hawkbitUri.empty())
             cli->setEndpoint(hawkbitUri);
 
         cli->defaultSleepTime = pollingTimeout;
         cli->currentSleepTime = pollingTimeout;
         cli->handler = handler;
-        cli->defaultHeaders = defaultHeaders;
         cli->serverCertificateVerify = verifyServerCertificate;
         cli->authErrorHandler = authErrorHandler;
+        cli->connectionPool->setIdleTimeout(connectionIdleTimeout);
+        cli->pollSchedule.setJitter(pollingJitter);
+        cli->pollSchedule.setSplay(initialSplay);
+        cli->pollRetryPolicy = pollRetryPolicy;
+        cli->feedbackRetryPolicy = feedbackRetryPolicy;
+        cli->downloadRetryPolicy = downloadRetryPolicy;
+        cli->pollErrorHandler = pollErrorHandler;
+        cli->segmentedDownload.segmentSize = downloadSegmentSize;
+        cli->segmentedDownload.maxConnections = downloadMaxConnections;
+        if (!pollTriggerSocket.empty()) {
+#ifndef _WIN32
+            cli->pollTrigger = std::make_unique<PollTrigger>(pollTriggerSocket, [cli]() {
+                cli->pollNow();
+            });
+#else
+            throw client_initialize_error("poll trigger socket is not supported on this platform");
+#endif
+        }
+        if (!artifactCacheDir.empty()) {
+            cli->artifactCache = std::make_shared<ArtifactCache>(artifactCacheDir, artifactCacheMaxSize);
+        }
+        if (asyncDeployment) {
+            cli->asyncActions = std::make_shared<AsyncActions>();
+            cli->asyncActions->setWakeUp([cli]() {
+                cli->onFeedbackQueued();
+            });
+        }
+        if (!feedbackOutboxDir.empty()) {
+            cli->feedbackOutbox = std::unique_ptr<FeedbackOutbox>(new FeedbackOutbox(
+                    feedbackOutboxDir, feedbackRetryPolicy, [cli](const FeedbackOutbox::Entry &entry) {
+                        cli->deliverFeedback(entry);
+                    }));
+        }
+
+        if (certRenewalFraction > 0) {
+            if (certRenewalFraction >= 1) {
+                throw client_initialize_error("certificate renewal fraction should be less than 1");
+            }
+            if (!authErrorHandler) {
+                throw client_initialize_error("AuthErrorHandler is required for certificate renewal");
+            }
+            cli->certRenewal = std::unique_ptr<CertificateRenewal>(new CertificateRenewal(
+                    certRenewalFraction, [cli]() {
+                        return cli->callAuthErrorHandler();
+                    }));
+        }
 
         if (authVariant == AuthorizeVariants::M_TLS_KEYPAIR) {
             cli->setTLS(crt, key);
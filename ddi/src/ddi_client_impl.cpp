@@ -1,17 +1,23 @@
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <exception>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
 #include <thread>
 #include <string>
 #include <utility>
+#include <vector>
 
 #define RAPIDJSON_HAS_STDSTRING 1
 
 #include "rapidjson/document.h"
-#include "rapidjson/stringbuffer.h"
-#include "rapidjson/writer.h"
 
 #include "ddi_client_impl.hpp"
 #include "response_impl.hpp"
 #include "actions_impl.hpp"
+#include "hash_verifier.hpp"
 #include "utils.hpp"
 
 
@@ -28,69 +34,256 @@ namespace ddi {
             throw http_unexpected_code_exception(presented, expected);
     }
 
-    class AuthRestoreHandler_ : public AuthRestoreHandler {
-        HawkbitCommunicationClient *cli;
-    public:
-        explicit AuthRestoreHandler_(HawkbitCommunicationClient *cli_) : cli(cli_) {}
-
-        void setTLS(const std::string &crt, const std::string &key) override {
-            cli->setTLS(crt, key);
+    void HawkbitCommunicationClient::run() {
+        {
+            std::lock_guard<std::mutex> lock(runMutex);
+            if (running) throw client_initialize_error("client is already running");
+            running = true;
+            stopRequested = false;
+            runThreadId = std::this_thread::get_id();
         }
 
-        void setEndpoint(const std::string &endpoint) override {
-            cli->setEndpoint(endpoint);
+        try {
+            runLoop();
+        } catch (...) {
+            setStopped();
+            throw;
         }
+        setStopped();
+    }
+
+    void HawkbitCommunicationClient::runAsync() {
+        std::unique_lock<std::mutex> lock(runMutex);
+        if (running) throw client_initialize_error("client is already running");
+        running = true;
+        stopRequested = false;
+        asyncError = nullptr;
+        // loop could be finished by exception without stop() call
+        auto finished = std::move(asyncThread);
+
+        asyncThread = std::thread([this]() {
+            {
+                std::lock_guard<std::mutex> lock(runMutex);
+                runThreadId = std::this_thread::get_id();
+            }
+            try {
+                runLoop();
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(runMutex);
+                asyncError = std::current_exception();
+            }
+            setStopped();
+        });
+        lock.unlock();
 
-        void setDeviceToken(const std::string &token) override {
-            cli->setDeviceToken(token);
+        if (finished.joinable()) {
+            finished.join();
         }
+    }
 
-        void setGatewayToken(const std::string &token) override {
-            cli->setGatewayToken(token);
+    void HawkbitCommunicationClient::stop() {
+        std::unique_lock<std::mutex> lock(runMutex);
+        stopRequested = true;
+        runStateChanged.notify_all();
+        if (running && runThreadId == std::this_thread::get_id()) {
+            // called from handler, loop will be finished when handler returns
+            return;
         }
 
-        void setEndpoint(std::string &hawkbitEndpoint, const std::string &controllerId,
-                         const std::string &tenant = "default") override {
+        runStateChanged.wait(lock, [this]() { return !running; });
+        auto thread = std::move(asyncThread);
+        auto error = asyncError;
+        asyncError = nullptr;
+        lock.unlock();
 
-            cli->setEndpoint(hawkbitEndpoint, controllerId, tenant);
-        };
-    };
+        if (thread.joinable()) {
+            thread.join();
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    HawkbitCommunicationClient::~HawkbitCommunicationClient() {
+        if (asyncActions) {
+            // contexts held by handler can outlive client
+            asyncActions->setWakeUp(nullptr);
+        }
+        if (asyncThread.joinable()) {
+            try {
+                stop();
+            } catch (...) {
+                // error has no receiver anymore
+            }
+        }
+        // sender and renewal threads use client, so they are stopped before members are destroyed
+        certRenewal.reset();
+        feedbackOutbox.reset();
+    }
 
-    [[noreturn]] void HawkbitCommunicationClient::run() {
+    void HawkbitCommunicationClient::runLoop() {
+        auto hawkbitURI = loadCredentials()->hawkbitURI;
         if (hawkbitURI.isEmpty()) {
             if (!authErrorHandler)  throw client_initialize_error("endpoint or AuthErrorHandler is not set");
-            authErrorHandler->onAuthError(
-                    std::make_unique<AuthRestoreHandler_>(this));
+            callAuthErrorHandler();
         }
+        // feedback left from previous run is sent when authorization is set
+        if (feedbackOutbox) {
+            feedbackOutbox->start();
+        }
+
+        // delays after failed polls, reset by successful one
+        Backoff failedPolls(pollRetryPolicy);
+        auto deadline = pollSchedule.first(PollSchedule::Clock::now());
+        sleepUntil(deadline);
+        while (!isStopRequested()) {
+            {
+                // triggers received till now are served by this poll
+                std::lock_guard<std::mutex> lock(runMutex);
+                pollRequested = false;
+            }
+            // poll triggered before its deadline starts new period
+            auto pollStart = PollSchedule::Clock::now();
+            auto periodStart = pollStart < deadline ? pollStart : deadline;
+
+            int sleepTime;
+            int failureDelay = 0;
+            try {
+                sleepTime = pollOnce();
+                failedPolls = Backoff(pollRetryPolicy);
+            } catch (...) {
+                if (!reportPollError(std::current_exception())) throw;
+                sleepTime = currentSleepTime;
+                failureDelay = failedPolls.canRetry() ? failedPolls.nextDelay() : pollRetryPolicy.maxDelay;
+            }
+            auto now = PollSchedule::Clock::now();
+            deadline = sleepTime > 0 ? pollSchedule.next(periodStart, sleepTime, now) : now;
+            deadline = std::max(deadline, now + std::chrono::milliseconds(failureDelay));
+            sleepUntil(deadline);
+        }
+    }
 
-        while (true) {
-            ignoreSleep = false;
-            doPoll();
-            if (!ignoreSleep && currentSleepTime > 0)
-                std::this_thread::sleep_for(std::chrono::milliseconds(currentSleepTime));
+    int HawkbitCommunicationClient::pollOnce() {
+        ignoreSleep = false;
+        sendQueuedFeedback();
+        doPoll();
+        return ignoreSleep ? 0 : currentSleepTime;
+    }
+
+    void HawkbitCommunicationClient::setStopped() {
+        std::lock_guard<std::mutex> lock(runMutex);
+        running = false;
+        runThreadId = std::thread::id();
+        runStateChanged.notify_all();
+    }
+
+    bool HawkbitCommunicationClient::isStopRequested() {
+        std::lock_guard<std::mutex> lock(runMutex);
+        return stopRequested;
+    }
+
+    void HawkbitCommunicationClient::sleepUntil(PollSchedule::Clock::time_point deadline) {
+        std::unique_lock<std::mutex> lock(runMutex);
+        while (runStateChanged.wait_until(lock, deadline, [this]() {
+            return stopRequested || pollRequested || feedbackQueued;
+        })) {
+            if (stopRequested || pollRequested) {
+                return;
+            }
+            // feedback is sent without waiting for the next poll
+            feedbackQueued = false;
+            lock.unlock();
+            try {
+                sendQueuedFeedback();
+            } catch (...) {
+                // feedback is sent again by the next poll
+                if (!reportPollError(std::current_exception())) throw;
+            }
+            lock.lock();
         }
     }
 
-    httplib::Client HawkbitCommunicationClient::newHttpClient(uri::URI &hostEndpoint) const {
-        // key pair auth
-        if (mTLSKeypair.isSet) {
-            BIO *bio_crt = BIO_new(BIO_s_mem());
-            BIO_puts(bio_crt, mTLSKeypair.crt.c_str());
-            X509 *certificate = PEM_read_bio_X509(bio_crt, nullptr, nullptr, nullptr);
-            BIO_free(bio_crt);
+    void HawkbitCommunicationClient::onFeedbackQueued() {
+        std::lock_guard<std::mutex> lock(runMutex);
+        feedbackQueued = true;
+        runStateChanged.notify_all();
+    }
+
+    void HawkbitCommunicationClient::sendQueuedFeedback() {
+        if (!asyncActions) {
+            return;
+        }
+        QueuedFeedback *feedback;
+        while ((feedback = asyncActions->front()) != nullptr) {
+            jsonArena.reset();
+            postFeedback(feedback->actionURI, feedback->response.get(), feedback->actionId);
+            asyncActions->pop();
+        }
+    }
 
-            BIO *bio_key = BIO_new(BIO_s_mem());
-            BIO_puts(bio_key, mTLSKeypair.key.c_str());
-            EVP_PKEY *key = PEM_read_bio_PrivateKey(bio_key, nullptr, nullptr, nullptr);
-            BIO_free(bio_key);
+    bool HawkbitCommunicationClient::reportPollError(std::exception_ptr error) {
+        // without handler nobody would know about failing polls (ex. revoked credentials), so run() stops
+        if (!pollErrorHandler) {
+            return false;
+        }
+        try {
+            std::rethrow_exception(error);
+        } catch (http_lib_error &e) {
+            pollErrorHandler(e);
+        } catch (http_unexpected_code_exception &e) {
+            pollErrorHandler(e);
+        } catch (unauthorized_exception &e) {
+            pollErrorHandler(e);
+        } catch (unexpected_payload &e) {
+            pollErrorHandler(e);
+        } catch (...) {
+            return false;
+        }
+        return true;
+    }
 
+    void HawkbitCommunicationClient::pollNow() {
+        std::lock_guard<std::mutex> lock(runMutex);
+        pollRequested = true;
+        runStateChanged.notify_all();
+    }
 
-            return httplib::Client(hostEndpoint.getScheme() + "://" + hostEndpoint.getAuthority(),
-                                   certificate, key);
+    TLSSessionStatistics HawkbitCommunicationClient::getTLSSessionStatistics() {
+        TLSSessionStatistics statistics;
+        auto sessionCache = loadCredentials()->tlsContext->getSessionCache();
+        if (sessionCache != nullptr) {
+            statistics.hits = sessionCache->getHits();
+            statistics.misses = sessionCache->getMisses();
         }
+        return statistics;
+    }
+
+    std::unique_ptr<httplib::Client> HawkbitCommunicationClient::newHttpClient(uri::URI &hostEndpoint,
+                                                                               TLSContext &tlsContext) const {
+        std::unique_ptr<httplib::Client> cli;
+        auto schemeAndAuthority = hostEndpoint.getScheme() + "://" + hostEndpoint.getAuthority();
+        // key pair auth is always done over TLS
+        if (tlsContext.hasKeyPair() || hostEndpoint.getScheme() == "https") {
+            cli = std::make_unique<httplib::Client>(schemeAndAuthority, tlsContext.getContext());
+            if (!tlsContext.hasKeyPair()) {
+                cli->enable_server_certificate_verification(serverCertificateVerify);
+            }
 
-        auto cli = httplib::Client(hostEndpoint.getScheme() + "://" + hostEndpoint.getAuthority());
-        cli.enable_server_certificate_verification(serverCertificateVerify);
+            auto sessionCache = tlsContext.getSessionCache();
+            if (sessionCache != nullptr) {
+                cli->set_handshake_callbacks(
+                        [sessionCache, schemeAndAuthority](SSL *ssl) {
+                            sessionCache->offerSession(ssl, schemeAndAuthority);
+                        },
+                        [sessionCache](SSL *ssl) {
+                            sessionCache->onHandshakeDone(ssl);
+                        });
+            }
+        } else {
+            cli = std::make_unique<httplib::Client>(schemeAndAuthority);
+        }
+        // connection will be returned to connectionPool and reused by next requests
+        cli->set_keep_alive(true);
 
         return cli;
     }
@@ -129,34 +322,90 @@ namespace ddi {
             return;
         }
 
-        rapidjson::Document document;
-        document.SetObject();
-
-        // fill data object
-        rapidjson::Value data(rapidjson::kObjectType);
-        for (auto &val: requestData) {
-            rapidjson::Value key(val.first, document.GetAllocator());
-            rapidjson::Value value(val.second, document.GetAllocator());
-            data.AddMember(key, value, document.GetAllocator());
+        // hawkBit keeps asking till data is uploaded, so every request is answered with exactly one PUT:
+        //  - changed and added keys with "merge" (empty merge if nothing changed);
+        //  - full data with "replace" if keys were removed, so server is never left half-updated;
+        //  - full data with "replace" if previous upload failed, server state is unknown then
+        auto delivered = lastConfig.delivered;
+        lastConfig.delivered = false;
+        std::vector<ConfigEntry> changed;
+        bool removed = false;
+        if (delivered) {
+            // both maps are sorted by key
+            auto last = lastConfig.values.cbegin();
+            for (const auto &val: requestData) {
+                while (last != lastConfig.values.cend() && last->first < val.first) {
+                    removed = true;
+                    ++last;
+                }
+                if (last == lastConfig.values.cend() || last->first != val.first) {
+                    changed.emplace_back(&val.first, &val.second);
+                    continue;
+                }
+                if (last->second != val.second) {
+                    changed.emplace_back(&val.first, &val.second);
+                }
+                ++last;
+            }
+            removed = removed || last != lastConfig.values.cend();
         }
 
-        document.AddMember("data", data, document.GetAllocator());
-        auto builder = ResponseBuilder::newInstance();
-        auto resp = builder->setFinished(Response::SUCCESS)->setExecution(Response::CLOSED)->build();
-
-        fillResponseDocument(resp.get(), document, -1);
-
-        rapidjson::StringBuffer buf;
-        rapidjson::Writer<rapidjson::StringBuffer> writer(buf);
-        document.Accept(writer);
+        if (delivered && !removed) {
+            putConfigData(followURI, "merge", changed);
+        } else {
+            changed.clear();
+            for (const auto &val: requestData) {
+                changed.emplace_back(&val.first, &val.second);
+            }
+            putConfigData(followURI, "replace", changed);
+        }
 
-        retryHandler(followURI, [&](httplib::Client &cli) {
-            return cli.Put(followURI.getPath().c_str(), defaultHeaders, buf.GetString(), "application/json");
-        });
+        lastConfig.values = std::move(requestData);
+        lastConfig.delivered = true;
 
         ignoreSleep = req->isIgnoredSleep();
     }
 
+    // see documentation: https://www.eclipse.org/hawkbit/rest-api/rootcontroller-api-guide/#_put_tenant_controller_v1_controllerid_configdata
+    void HawkbitCommunicationClient::putConfigData(uri::URI &followURI, const char *mode,
+                                                   const std::vector<ConfigEntry> &entries) {
+        // body is written directly to buffer, large data is not copied to document first
+        auto &buf = jsonArena.newOutput();
+        JsonArena::Writer writer(buf, &jsonArena.getAllocator());
+        writer.StartObject();
+        writer.Key("mode");
+        writer.String(mode);
+
+        writer.Key("data");
+        writer.StartObject();
+        for (const auto &entry: entries) {
+            writer.Key(entry.first->c_str(), (rapidjson::SizeType) entry.first->length());
+            writer.String(entry.second->c_str(), (rapidjson::SizeType) entry.second->length());
+        }
+        writer.EndObject();
+
+        writer.Key("status");
+        writer.StartObject();
+        writer.Key("result");
+        writer.StartObject();
+        writer.Key("finished");
+        writer.String(Response::finishedToString(Response::SUCCESS).c_str());
+        writer.EndObject();
+        writer.Key("execution");
+        writer.String(Response::executionToString(Response::CLOSED).c_str());
+        writer.Key("details");
+        writer.StartArray();
+        writer.EndArray();
+        writer.EndObject();
+
+        writer.EndObject();
+
+        retryHandler(followURI, [&](httplib::Client &cli, const httplib::Headers &headers) {
+            return cli.Put(followURI.getPath().c_str(), headers, buf.GetString(), buf.GetSize(),
+                           "application/json");
+        }, feedbackRetryPolicy);
+    }
+
 
     // see documentation: https://www.eclipse.org/hawkbit/rest-api/rootcontroller-api-guide/#_post_tenant_controller_v1_controllerid_cancelaction_actionid_feedback
     std::string formatFeedbackPath(uri::URI uri) {
@@ -168,88 +417,167 @@ namespace ddi {
         return path;
     }
 
+    std::string feedbackURL(uri::URI &actionURI) {
+        return actionURI.getScheme() + "://" + actionURI.getAuthority() + formatFeedbackPath(actionURI);
+    }
+
+    bool HawkbitCommunicationClient::isFeedbackPending(uri::URI &actionURI) {
+        return feedbackOutbox && feedbackOutbox->hasPendingFinal(feedbackURL(actionURI));
+    }
+
     void HawkbitCommunicationClient::followCancelAction(uri::URI &followURI) {
-        auto resp = retryHandler(followURI, [&](httplib::Client &cli) {
-            return cli.Get(followURI.getPath().c_str(), defaultHeaders);
-        });
+        if (isFeedbackPending(followURI)) {
+            return;
+        }
+        auto resp = retryHandler(followURI, [&](httplib::Client &cli, const httplib::Headers &headers) {
+            return cli.Get(followURI.getPath().c_str(), headers);
+        }, pollRetryPolicy);
 
-        auto cancelAction = CancelAction_::fromString(resp->body);
+        auto cancelAction = CancelAction_::fromString(resp->body, jsonArena);
         auto actionId = cancelAction->getId();
+        auto stopId = cancelAction->getStopId();
+        if (asyncActions) {
+            asyncActions->cancel(stopId);
+        }
         auto cliResp = handler->onCancelAction(std::move(cancelAction));
 
-        rapidjson::Document document;
-        document.SetObject();
+        postFeedback(followURI, cliResp.get(), actionId);
+        // accepted cancel closes deployment, its feedback is not sent anymore
+        if (asyncActions && cliResp->getExecution() == Response::CLOSED) {
+            asyncActions->finish(stopId);
+        }
 
-        fillResponseDocument(cliResp.get(), document, actionId);
+        ignoreSleep = cliResp->isIgnoredSleep();
+    }
 
-        rapidjson::StringBuffer buf;
-        rapidjson::Writer<rapidjson::StringBuffer> writer(buf);
-        document.Accept(writer);
+    // action id is the last segment of action href (.../deploymentBase/{actionId}). Returns -1 if it is not a number
+    int actionIdFromURI(uri::URI &actionURI) {
+        auto path = actionURI.getPath();
+        auto begin = path.find_last_of('/') + 1;
+        if (begin == path.length() || path.find_first_not_of("0123456789", begin) != std::string::npos) {
+            return -1;
+        }
         try {
-            retryHandler(followURI, [&](httplib::Client &cli) {
-                return cli.Post(formatFeedbackPath(
-                        followURI).c_str(), defaultHeaders, buf.GetString(), "application/json");
-            });
-
-            if (cliResp->getDeliveryListener()) {
-                cliResp->getDeliveryListener()->onSuccessfulDelivery();
-            }
-            // catch only error http code, if no handler defined pass through
-        } catch (http_unexpected_code_exception &e) {
-            if (cliResp->getDeliveryListener()) {
-                cliResp->getDeliveryListener()->onError();
-            } else {
-                throw e;
-            }
+            return std::stoi(path.substr(begin));
+        } catch (std::out_of_range &) {
+            return -1;
         }
-
-        ignoreSleep = cliResp->isIgnoredSleep();
     }
 
     void HawkbitCommunicationClient::followDeploymentBase(uri::URI &followURI) {
-        auto resp = retryHandler(followURI, [&](httplib::Client &cli) {
-            return cli.Get(followURI.getPath().c_str(), defaultHeaders);
-        });
+        // deployment in progress is not requested again
+        if (isFeedbackPending(followURI) || (asyncActions && asyncActions->isActive(actionIdFromURI(followURI)))) {
+            return;
+        }
+        auto resp = retryHandler(followURI, [&](httplib::Client &cli, const httplib::Headers &headers) {
+            return cli.Get(followURI.getPath().c_str(), headers);
+        }, pollRetryPolicy);
 
-        auto deploymentBase = DeploymentBase_::from(resp->body, this);
+        auto deploymentBase = DeploymentBase_::from(resp->body, this, jsonArena);
         auto actionId = deploymentBase->getId();
-        auto cliResp = handler->onDeploymentAction(std::move(deploymentBase));
+        if (!asyncActions) {
+            auto cliResp = handler->onDeploymentAction(std::move(deploymentBase));
+            postFeedback(followURI, cliResp.get(), actionId);
+            ignoreSleep = cliResp->isIgnoredSleep();
+            return;
+        }
+
+        if (asyncActions->isActive(actionId)) {
+            return;
+        }
+        // registered before handler call, so feedback can be sent from other thread while handler is running
+        auto cancellation = static_cast<DeploymentBase_ &>(*deploymentBase).getCancellation();
+        auto context = std::make_shared<ActionContext_>(asyncActions, asyncActions->start(actionId, cancellation),
+                                                        followURI, actionId);
+        std::unique_ptr<Response> cliResp;
+        try {
+            cliResp = handler->onDeploymentActionAsync(std::move(deploymentBase), std::move(context));
+        } catch (...) {
+            asyncActions->finish(actionId);
+            throw;
+        }
+        if (cliResp == nullptr || isFinalExecution(cliResp->getExecution())) {
+            asyncActions->finish(actionId);
+        }
+        postFeedback(followURI, cliResp.get(), actionId);
+
+        ignoreSleep = cliResp->isIgnoredSleep();
+    }
 
-        rapidjson::Document document;
-        document.SetObject();
-        fillResponseDocument(cliResp.get(), document, actionId);
+    void HawkbitCommunicationClient::postFeedback(uri::URI &actionURI, Response *response, int actionId) {
+        rapidjson::Document document(rapidjson::kObjectType, &jsonArena.getAllocator());
+        fillResponseDocument(response, document, actionId);
 
-        rapidjson::StringBuffer buf;
-        rapidjson::Writer<rapidjson::StringBuffer> writer(buf);
-        document.Accept(writer);
+        auto &buf = jsonArena.serialize(document);
+        if (feedbackOutbox) {
+            feedbackOutbox->push(feedbackURL(actionURI), response->getExecution(), buf.GetString(), buf.GetSize(),
+                                 response->getDeliveryListener());
+            return;
+        }
         try {
-            retryHandler(followURI, [&](httplib::Client &cli) {
-                return cli.Post(
-                        formatFeedbackPath(followURI).c_str(), defaultHeaders, buf.GetString(), "application/json");
-            });
+            retryHandler(actionURI, [&](httplib::Client &cli, const httplib::Headers &headers) {
+                return cli.Post(formatFeedbackPath(actionURI).c_str(), headers, buf.GetString(), buf.GetSize(),
+                                "application/json");
+            }, feedbackRetryPolicy);
 
-            if (cliResp->getDeliveryListener()) {
-                cliResp->getDeliveryListener()->onSuccessfulDelivery();
+            if (response->getDeliveryListener()) {
+                response->getDeliveryListener()->onSuccessfulDelivery();
             }
             // catch only error http code, if no handler defined pass through
         } catch (http_unexpected_code_exception &e) {
-            if (cliResp->getDeliveryListener()) {
-                cliResp->getDeliveryListener()->onError();
+            if (response->getDeliveryListener()) {
+                response->getDeliveryListener()->onError();
             } else {
                 throw e;
             }
         }
+    }
 
-        ignoreSleep = cliResp->isIgnoredSleep();
+    void HawkbitCommunicationClient::deliverFeedback(const FeedbackOutbox::Entry &entry) {
+        auto feedbackURI = uri::URI::fromString(entry.url);
+        // outbox repeats failed delivery itself
+        retryHandler(feedbackURI, [&](httplib::Client &cli, const httplib::Headers &headers) {
+            return cli.Post(feedbackURI.getPath().c_str(), headers, entry.body.data(), entry.body.size(),
+                            "application/json");
+        }, NO_RETRY_POLICY);
     }
 
+    const char *ETAG_HEADER = "ETag";
+    const char *IF_NONE_MATCH_HEADER = "If-None-Match";
+
     void HawkbitCommunicationClient::doPoll() {
+        jsonArena.reset();
+
         // firstly do GET request to default endpoint. hawkBit send meta for next poll and
         //  action list to follow
-        auto resp = retryHandler(hawkbitURI, [&](httplib::Client &cli) {
-            return cli.Get(hawkbitURI.getPath().c_str(), defaultHeaders);
-        });
-        auto polingData = PollingData_::fromString(resp->body);
+        auto hawkbitURI = loadCredentials()->hawkbitURI;
+        auto endpoint = hawkbitURI.getScheme() + "://" + hawkbitURI.getAuthority() + hawkbitURI.getPath();
+        if (endpoint != lastEndpoint) {
+            // cached resource and delivered config data belong to the previous endpoint
+            lastPoll = {};
+            lastConfig = {};
+            lastEndpoint = endpoint;
+        }
+        auto resp = retryHandler(hawkbitURI, [&](httplib::Client &cli, const httplib::Headers &headers) {
+            if (!lastPoll.data || lastPoll.etag.empty()) {
+                return cli.Get(hawkbitURI.getPath().c_str(), headers);
+            }
+            auto conditionalHeaders = headers;
+            conditionalHeaders.insert({IF_NONE_MATCH_HEADER, lastPoll.etag});
+            return cli.Get(hawkbitURI.getPath().c_str(), conditionalHeaders);
+        }, pollRetryPolicy, {HTTP_OK, HTTP_NOT_MODIFIED});
+
+        // unchanged resource is not parsed again
+        if (resp->status == HTTP_OK && (!lastPoll.data || resp->body != lastPoll.body)) {
+            lastPoll.data = PollingData_::fromString(resp->body, jsonArena);
+            lastPoll.body = std::move(resp->body);
+        }
+        if (resp->has_header(ETAG_HEADER)) {
+            lastPoll.etag = resp->get_header_value(ETAG_HEADER);
+        } else if (resp->status == HTTP_OK) {
+            lastPoll.etag.clear();
+        }
+        auto &polingData = lastPoll.data;
         // handle if sleepTime not defined by hawkBit
         currentSleepTime = (polingData->getSleepTime() > 0) ? polingData->getSleepTime() : defaultSleepTime;
         auto followURI = polingData->getFollowURI();
@@ -265,71 +593,460 @@ namespace ddi {
         }
     }
 
-    void HawkbitCommunicationClient::downloadTo(uri::URI downloadURI, const std::string &path) {
-        std::ofstream file(path, std::ios::binary);
-        retryHandler(downloadURI, [&](httplib::Client &cli) {
-            return cli.Get(downloadURI.getPath().c_str(), defaultHeaders,
-                           [](const httplib::Response &r) {
-                               checkHttpCode(r.status, HTTP_OK);
-                               return true;
-                           },
-                           [&](const char *data, size_t size) {
-                               file.write(data, size);
-                               return !file.bad();
-                           }
-            );
+    const char *RANGE_HEADER = "Range";
+    const char *IF_RANGE_HEADER = "If-Range";
+    const char *CONTENT_RANGE_HEADER = "Content-Range";
+    const char *LAST_MODIFIED_HEADER = "Last-Modified";
+    const char *RETRY_AFTER_HEADER = "Retry-After";
+
+    // get first byte position from Content-Range header ("bytes N-M/T")
+    long long contentRangeStart(const httplib::Response &r) {
+        auto contentRange = r.get_header_value(CONTENT_RANGE_HEADER);
+        long long start;
+        if (sscanf(contentRange.c_str(), "bytes %lld-", &start) != 1) {
+            return -1;
+        }
+        return start;
+    }
+
+    void HawkbitCommunicationClient::resumableDownload(uri::URI &downloadURI, long long from, long long to,
+                                                       std::string &validator,
+                                                       const std::function<bool(const char *, size_t)> &receiver,
+                                                       const std::function<void()> &onRestart,
+                                                       CancellationToken *cancellation) {
+        long long received = 0;
+        // only part of resource is requested, server must answer with 206
+        bool segment = from > 0 || to >= 0;
+        bool stoppedByReceiver = false;
+        Backoff backoff(downloadRetryPolicy);
+
+        for (;;) {
+            if (isCanceled(cancellation)) {
+                throw download_canceled();
+            }
+            auto position = from + received;
+
+            std::string retryAfter;
+            std::exception_ptr error;
+            try {
+                // request is repeated here (from the last received byte), not by retryHandler
+                retryHandler(downloadURI, [&](httplib::Client &cli, const httplib::Headers &defaultHeaders) {
+                    auto headers = defaultHeaders;
+                    if (position > 0 || to >= 0) {
+                        headers.insert({RANGE_HEADER, "bytes=" + std::to_string(position) + "-" +
+                                                      (to >= 0 ? std::to_string(to) : "")});
+                        if (!validator.empty()) {
+                            headers.insert({IF_RANGE_HEADER, validator});
+                        }
+                    }
+                    // socket shutdown interrupts blocked read, connection is not reused after it
+                    CancellationToken::Subscription subscription(cancellation, [&cli]() { cli.stop(); });
+                    if (isCanceled(cancellation)) {
+                        throw download_canceled();
+                    }
+                    return cli.Get(downloadURI.getPath().c_str(), headers,
+                                   [&](const httplib::Response &r) {
+                                       if ((position > 0 || to >= 0) && r.status == HTTP_PARTIAL_CONTENT) {
+                                           if (contentRangeStart(r) != position) {
+                                               throw http_unexpected_code_exception(r.status, HTTP_OK);
+                                           }
+                                       } else {
+                                           retryAfter = r.get_header_value(RETRY_AFTER_HEADER);
+                                           checkHttpCode(r.status, HTTP_OK);
+                                           // range ignored or file changed
+                                           if (segment) {
+                                               throw http_unexpected_code_exception(r.status,
+                                                                                    HTTP_PARTIAL_CONTENT);
+                                           }
+                                           if (received > 0) {
+                                               // receive it from scratch
+                                               if (!onRestart) {
+                                                   throw http_unexpected_code_exception(r.status,
+                                                                                        HTTP_PARTIAL_CONTENT);
+                                               }
+                                               onRestart();
+                                               received = 0;
+                                           }
+                                           validator.clear();
+                                       }
+
+                                       if (validator.empty()) {
+                                           validator = r.get_header_value(ETAG_HEADER);
+                                           // weak validators cannot be used in If-Range
+                                           if (validator.empty() || validator.rfind("W/", 0) == 0) {
+                                               validator = r.get_header_value(LAST_MODIFIED_HEADER);
+                                           }
+                                       }
+                                       return true;
+                                   },
+                                   [&](const char *data, size_t size) {
+                                       if (isCanceled(cancellation)) {
+                                           throw download_canceled();
+                                       }
+                                       if (!receiver(data, size)) {
+                                           stoppedByReceiver = true;
+                                           return false;
+                                       }
+                                       received += (long long) size;
+                                       return true;
+                                   }
+                    );
+                }, NO_RETRY_POLICY, {HTTP_OK, HTTP_PARTIAL_CONTENT});
+                return;
+            } catch (http_lib_error &) {
+                // connection lost. Stopped by receiver is not a connection error
+                if (stoppedByReceiver) throw;
+                if (isCanceled(cancellation)) {
+                    throw download_canceled();
+                }
+                error = std::current_exception();
+            } catch (http_unexpected_code_exception &e) {
+                if (!isRetryableCode(e.getCode())) throw;
+                error = std::current_exception();
+            }
+
+            if (!backoff.canRetry() ||
+                !waitBeforeRetry(backoff.nextDelay(parseRetryAfter(retryAfter)), cancellation)) {
+                if (isCanceled(cancellation)) {
+                    throw download_canceled();
+                }
+                std::rethrow_exception(error);
+            }
+        }
+    }
+
+    bool HawkbitCommunicationClient::segmentedDownloadTo(const DownloadRequest &request, const std::string &path) {
+        auto segmentSize = segmentedDownload.segmentSize;
+        auto segments = (request.size + segmentSize - 1) / segmentSize;
+        auto downloadURI = request.uri;
+        std::string validator;
+
+        // segments are written on their positions
+        if (!preallocateFile(path, request.size)) {
+            return false;
+        }
+
+        auto downloadSegment = [&](long long segmentNum, std::string &segmentValidator,
+                                   const std::function<bool()> &isFailed, HashVerifier *verifier) {
+            auto from = segmentNum * segmentSize;
+            auto to = std::min(from + segmentSize, request.size) - 1;
+            std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+            file.seekp(from);
+            resumableDownload(downloadURI, from, to, segmentValidator, [&](const char *data, size_t size) {
+                if (verifier != nullptr) {
+                    verifier->update(data, size);
+                }
+                file.write(data, size);
+                if (request.onProgress) {
+                    request.onProgress((long long) size);
+                }
+                return !file.bad() && !isFailed();
+            }, nullptr, request.cancellation);
+        };
+
+        // first segment shows that server supports ranges, and gives validator for other requests.
+        //  It is hashed while downloaded
+        if (request.verifier != nullptr) {
+            request.verifier->reset();
+        }
+        try {
+            downloadSegment(0, validator, []() { return false; }, request.verifier);
+        } catch (http_unexpected_code_exception &e) {
+            if (isRetryableCode(e.getCode())) throw;
+            // range is ignored, download as single stream
+            if (request.verifier != nullptr) {
+                request.verifier->reset();
+            }
+            return false;
+        }
+
+        // other segments complete out of order: hashes are updated in order while downloads go on, when segment
+        //  extends completed prefix of file it's read back (just written, so it comes from page cache)
+        std::mutex hashMutex;
+        std::vector<bool> completed((size_t) segments, false);
+        long long hashedSegments = 1;
+        auto segmentCompleted = [&](long long segmentNum) {
+            if (request.verifier == nullptr) {
+                return;
+            }
+            std::lock_guard<std::mutex> lock(hashMutex);
+            completed[(size_t) segmentNum] = true;
+            if (segmentNum != hashedSegments) {
+                return;
+            }
+            std::ifstream file(path, std::ios::binary);
+            std::vector<char> buf(64 * 1024);
+            file.seekg(hashedSegments * segmentSize);
+            for (; hashedSegments < segments && completed[(size_t) hashedSegments]; hashedSegments++) {
+                auto left = std::min(segmentSize, request.size - hashedSegments * segmentSize);
+                while (left > 0 && file.read(buf.data(), (std::streamsize) std::min<long long>(left, buf.size()))) {
+                    request.verifier->update(buf.data(), (size_t) file.gcount());
+                    left -= file.gcount();
+                }
+            }
+        };
+
+        std::atomic<long long> nextSegment{1};
+        std::atomic<bool> failed{false};
+        std::exception_ptr error;
+        std::mutex errorMutex;
+
+        auto worker = [&]() {
+            auto segmentValidator = validator;
+            for (auto segmentNum = nextSegment++; segmentNum < segments && !failed; segmentNum = nextSegment++) {
+                try {
+                    downloadSegment(segmentNum, segmentValidator, [&]() { return (bool) failed; }, nullptr);
+                    segmentCompleted(segmentNum);
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(errorMutex);
+                    if (!failed.exchange(true)) {
+                        error = std::current_exception();
+                    }
+                }
+            }
+        };
+
+        std::vector<std::thread> workers;
+        auto workersCount = std::min<long long>(segmentedDownload.maxConnections, segments - 1);
+        for (long long i = 0; i < workersCount; i++) {
+            workers.emplace_back(worker);
+        }
+        for (auto &w: workers) {
+            w.join();
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+        return true;
+    }
+
+    bool HawkbitCommunicationClient::readFromCache(const DownloadRequest &request,
+                                                   const std::function<bool(const char *, size_t)> &receiver) {
+        if (!artifactCache || request.sha256.empty()) {
+            return false;
+        }
+        return artifactCache->read(request.sha256, [&](const char *data, size_t size) {
+            if (request.verifier != nullptr) {
+                request.verifier->update(data, size);
+            }
+            if (request.onProgress) {
+                request.onProgress((long long) size);
+            }
+            return receiver(data, size);
         });
+    }
+
+    void HawkbitCommunicationClient::downloadTo(const DownloadRequest &request, const std::string &path) {
+        if (artifactCache && !request.sha256.empty()) {
+            std::ofstream file(path, std::ios::binary | std::ios::trunc);
+            if (readFromCache(request, [&](const char *data, size_t size) {
+                file.write(data, size);
+                return !file.bad();
+            })) {
+                return;
+            }
+        }
+
+        downloadFromServer(request, path);
+        if (artifactCache && !request.sha256.empty()) {
+            artifactCache->store(request.sha256, path);
+        }
+    }
+
+    void HawkbitCommunicationClient::downloadFromServer(const DownloadRequest &request, const std::string &path) {
+        if (segmentedDownload.segmentSize > 0 && segmentedDownload.maxConnections > 1
+            && request.size > segmentedDownload.segmentSize && segmentedDownloadTo(request, path)) {
+            return;
+        }
 
+        auto downloadURI = request.uri;
+        auto verifier = request.verifier;
+        std::string validator;
+        long long written = 0;
+        std::ofstream file(path, std::ios::binary);
+        resumableDownload(downloadURI, 0, -1, validator, [&](const char *data, size_t size) {
+            if (verifier != nullptr) {
+                verifier->update(data, size);
+            }
+            file.write(data, size);
+            written += (long long) size;
+            if (request.onProgress) {
+                request.onProgress((long long) size);
+            }
+            return !file.bad();
+        }, [&]() {
+            file.close();
+            file.open(path, std::ios::binary | std::ios::trunc);
+            if (verifier != nullptr) {
+                verifier->reset();
+            }
+            if (request.onProgress) {
+                request.onProgress(-written);
+            }
+            written = 0;
+        }, request.cancellation);
     }
 
     std::string HawkbitCommunicationClient::getBody(uri::URI downloadURI) {
-        return retryHandler(downloadURI, [&](httplib::Client &cli) {
-            return cli.Get(downloadURI.getPath().c_str(), defaultHeaders);
-        })->body;
+        return retryHandler(downloadURI, [&](httplib::Client &cli, const httplib::Headers &headers) {
+            return cli.Get(downloadURI.getPath().c_str(), headers);
+        }, downloadRetryPolicy)->body;
     }
 
-    void HawkbitCommunicationClient::downloadWithReceiver(uri::URI downloadURI,
+    void HawkbitCommunicationClient::downloadWithReceiver(const DownloadRequest &request,
                                                           std::function<bool(const char *, size_t)> func) {
-        retryHandler(downloadURI, [&](httplib::Client &cli) {
-            return cli.Get(downloadURI.getPath().c_str(), defaultHeaders,
-                           [](const httplib::Response &r) {
-                               checkHttpCode(r.status, HTTP_OK);
-                               return true;
-                           }, func
-            );
-        });
+        if (readFromCache(request, func)) {
+            return;
+        }
 
+        auto downloadURI = request.uri;
+        auto verifier = request.verifier;
+        std::unique_ptr<ArtifactCache::Writer> cacheEntry;
+        if (artifactCache && !request.sha256.empty()) {
+            cacheEntry = artifactCache->newEntry(request.sha256);
+        }
+        std::string validator;
+        // data already passed to receiver cannot be taken back, so download is resumed only if server supports ranges
+        resumableDownload(downloadURI, 0, -1, validator, [&](const char *data, size_t size) {
+            if (verifier != nullptr) {
+                verifier->update(data, size);
+            }
+            if (cacheEntry) {
+                cacheEntry->write(data, size);
+            }
+            if (request.onProgress) {
+                request.onProgress((long long) size);
+            }
+            return func(data, size);
+        }, nullptr, request.cancellation);
+        if (cacheEntry) {
+            cacheEntry->commit();
+        }
     }
 
-    httplib::Result HawkbitCommunicationClient::wrappedRequest(uri::URI reqUri, const std::function<httplib::Result(
-            httplib::Client &)> &func) {
-        auto cli = newHttpClient(reqUri);
-        auto resp = func(cli);
+    httplib::Result HawkbitCommunicationClient::wrappedRequest(uri::URI reqUri, const Request &func,
+                                                               const std::vector<int> &expectedCodes,
+                                                               std::string &retryAfter) {
+        // connection and headers are taken from the same snapshot
+        auto snapshot = loadCredentials();
+        auto cli = connectionPool->acquire(reqUri, snapshot->tlsContext, [&](uri::URI &u) {
+            return newHttpClient(u, *snapshot->tlsContext);
+        });
+        auto resp = [&]() {
+            try {
+                return func(*cli, snapshot->headers);
+            } catch (...) {
+                // exception from handler interrupts reading response, connection cannot be reused
+                cli.discard();
+                throw;
+            }
+        }();
         if (resp.error() != httplib::Error::Success) {
+            cli.discard();
             throw http_lib_error((int) resp.error());
         }
-        checkHttpCode(resp->status, HTTP_OK);
+        for (auto code: expectedCodes) {
+            if (resp->status == code) {
+                return resp;
+            }
+        }
+        retryAfter = resp->get_header_value(RETRY_AFTER_HEADER);
+        checkHttpCode(resp->status, expectedCodes.front());
         return resp;
     }
 
-    httplib::Result HawkbitCommunicationClient::retryHandler(uri::URI reqUri, const std::function<httplib::Result(
-            httplib::Client &)> &func) {
+    httplib::Result HawkbitCommunicationClient::authorizedRequest(uri::URI reqUri, const Request &func,
+                                                                  const std::vector<int> &expectedCodes,
+                                                                  std::string &retryAfter) {
         try {
-            return wrappedRequest(reqUri, func);
+            return wrappedRequest(reqUri, func, expectedCodes, retryAfter);
         } catch (unauthorized_exception &e) {
             if (!authErrorHandler) throw e;
-            authErrorHandler->onAuthError(
-                    std::make_unique<AuthRestoreHandler_>(this));
+            callAuthErrorHandler();
+        }
+
+        return wrappedRequest(reqUri, func, expectedCodes, retryAfter);
+    }
+
+    bool HawkbitCommunicationClient::callAuthErrorHandler() {
+        // handler may run on any thread, so it only records credentials. They are published as one snapshot
+        //  and client state used by polling thread is not touched
+        auto staging = std::make_shared<CredentialsStaging>();
+        {
+            std::lock_guard<std::mutex> lock(authErrorMutex);
+            authErrorHandler->onAuthError(std::unique_ptr<AuthRestoreHandler>(new StagingRestoreHandler(staging)));
+        }
+        auto updates = staging->take();
+        if (updates.empty()) {
+            return false;
+        }
+        updateCredentials(updates);
+        return true;
+    }
+
+    std::shared_ptr<const Credentials> HawkbitCommunicationClient::loadCredentials() const {
+        return std::atomic_load(&credentials);
+    }
+
+    void HawkbitCommunicationClient::updateCredentials(const std::vector<CredentialsUpdate> &updates) {
+        std::lock_guard<std::mutex> lock(credentialsMutex);
+        auto current = loadCredentials();
+        CredentialsEditor editor(*current);
+        for (auto &update: updates) {
+            update(editor);
+        }
+        auto updated = std::make_shared<const Credentials>(std::move(editor.get()));
+        // all updates are published at once, so no request is sent with half of them
+        std::atomic_store(&credentials, updated);
+
+        if (updated->tlsContext != current->tlsContext) {
+            // connections of old context are not reused, they are closed now
+            connectionPool->invalidate();
+            if (certRenewal) {
+                certRenewal->schedule(updated->tlsContext->hasKeyPair() ? updated->tlsContext->getCertificate()
+                                                                        : nullptr);
+            }
+        }
+    }
+
+    httplib::Result HawkbitCommunicationClient::retryHandler(uri::URI reqUri, const Request &func,
+                                                             const RetryPolicy &policy,
+                                                             const std::vector<int> &expectedCodes) {
+        Backoff backoff(policy);
+        for (;;) {
+            std::string retryAfter;
+            std::exception_ptr error;
+            try {
+                return authorizedRequest(reqUri, func, expectedCodes, retryAfter);
+            } catch (http_lib_error &) {
+                error = std::current_exception();
+            } catch (http_unexpected_code_exception &e) {
+                if (!isRetryableCode(e.getCode())) throw;
+                error = std::current_exception();
+            }
+
+            if (!backoff.canRetry() || !waitBeforeRetry(backoff.nextDelay(parseRetryAfter(retryAfter)))) {
+                std::rethrow_exception(error);
+            }
         }
+    }
 
-        return wrappedRequest(reqUri, func);;
+    bool HawkbitCommunicationClient::waitBeforeRetry(int ms, CancellationToken *cancellation) {
+        // canceled download wakes up waiting
+        CancellationToken::Subscription subscription(cancellation, [this]() {
+            std::lock_guard<std::mutex> lock(runMutex);
+            runStateChanged.notify_all();
+        });
+        std::unique_lock<std::mutex> lock(runMutex);
+        return !runStateChanged.wait_for(lock, std::chrono::milliseconds(ms), [&]() {
+            return stopRequested || isCanceled(cancellation);
+        });
     }
 
     void HawkbitCommunicationClient::setTLS(const std::string &crt, const std::string &key) {
-        mTLSKeypair.isSet = true;
-        mTLSKeypair.crt = crt;
-        mTLSKeypair.key = key;
-        defaultHeaders.erase(AUTHORIZATION_HEADER);
+        updateCredentials({[&](AuthRestoreHandler &editor) {
+            editor.setTLS(crt, key);
+        }});
     }
 
     std::string formatAuthHeader(const std::string &authType, const std::string &val) {
@@ -337,23 +1054,21 @@ namespace ddi {
     }
 
     void HawkbitCommunicationClient::setEndpoint(const std::string &endpoint) {
-        hawkbitURI = uri::URI::fromString(endpoint);
+        updateCredentials({[&](AuthRestoreHandler &editor) {
+            editor.setEndpoint(endpoint);
+        }});
     }
 
     void HawkbitCommunicationClient::setDeviceToken(const std::string &token) {
-        defaultHeaders.insert({AUTHORIZATION_HEADER,
-                               formatAuthHeader(TARGET_TOKEN_HEADER, token)});
-        mTLSKeypair.isSet = false;
-        mTLSKeypair.crt = "";
-        mTLSKeypair.key = "";
+        updateCredentials({[&](AuthRestoreHandler &editor) {
+            editor.setDeviceToken(token);
+        }});
     }
 
     void HawkbitCommunicationClient::setGatewayToken(const std::string &token) {
-        defaultHeaders.insert({AUTHORIZATION_HEADER,
-                               formatAuthHeader(GATEWAY_TOKEN_HEADER, token)});
-        mTLSKeypair.isSet = false;
-        mTLSKeypair.crt = "";
-        mTLSKeypair.key = "";
+        updateCredentials({[&](AuthRestoreHandler &editor) {
+            editor.setGatewayToken(token);
+        }});
     }
 
     void HawkbitCommunicationClient::setEndpoint(std::string &hawkbitEndpoint, const std::string &controllerId,
@@ -1,24 +1,50 @@
 #pragma once
 
-#include <string>
+#include <condition_variable>
+#include <exception>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #include "httplib.h"
 #include "uriparse.hpp"
 #include "ddi/hawkbit_event_handler.hpp"
 #include "ddi/hawkbit_exceptions.hpp"
+#include "action_context_impl.hpp"
 #include "actions_impl.hpp"
+#include "artifact_cache.hpp"
+#include "cert_renewal.hpp"
+#include "connection_pool.hpp"
+#include "credentials.hpp"
+#include "feedback_outbox.hpp"
+#include "json_arena.hpp"
+#include "poll_schedule.hpp"
+#include "poll_trigger.hpp"
+#include "retry_policy.hpp"
+#include "tls_context.hpp"
 #include "ddi/ddi_client.hpp"
 
 namespace ddi {
 
     struct PollingData_;
 
+    extern const char *AUTHORIZATION_HEADER;
+    extern const char *GATEWAY_TOKEN_HEADER;
+    extern const char *TARGET_TOKEN_HEADER;
+
+    std::string formatAuthHeader(const std::string &authType, const std::string &val);
+
     class HawkbitCommunicationClient : public DownloadProvider, public Client, public AuthRestoreHandler {
     protected:
-        uri::URI hawkbitURI;
-
-        httplib::Headers defaultHeaders;
+        // endpoint and authorization, replaced as a whole by updateCredentials. Read only by loadCredentials.
+        //  Set by builder or gateway, which also provides TLS context (gateway shares one by all controllers)
+        std::shared_ptr<const Credentials> credentials;
+        // serializes updates of credentials
+        std::mutex credentialsMutex;
 
         std::shared_ptr<EventHandler> handler;
         std::shared_ptr<AuthErrorHandler> authErrorHandler;
@@ -28,44 +54,201 @@ namespace ddi {
 
         bool ignoreSleep;
 
-        bool serverCertificateVerify = true;
+        // last response of controller base resource, reused if resource is not changed
+        struct {
+            std::string etag;
+            std::string body;
+            std::unique_ptr<PollingData_> data;
+        } lastPoll;
+
+        // config data delivered by the last configData upload, changes are compared with it
+        struct {
+            // values are kept (not hashes), so changed value is never taken for unchanged
+            std::map<std::string, std::string> values;
+            bool delivered = false;
+        } lastConfig;
 
+        // endpoint lastPoll and lastConfig were received from, they are dropped when endpoint is changed
+        std::string lastEndpoint;
+
+        // memory of JSON parsing and feedback serialization, reset before every poll
+        JsonArena jsonArena;
+
+        // deadlines of polls in run()
+        PollSchedule pollSchedule;
+
+        // retries of failed requests. Download retries are also used to resume interrupted download
+        RetryPolicy pollRetryPolicy;
+        RetryPolicy feedbackRetryPolicy;
+        RetryPolicy downloadRetryPolicy;
+
+        // failed polls are reported to it, polling continues
+        ClientErrorHandler pollErrorHandler;
+
+        // artifact split into segments downloaded in parallel. Disabled if segmentSize is 0
         struct {
-            std::string crt;
-            std::string key;
-            bool isSet = false;
-        } mTLSKeypair;
+            long long segmentSize = 0;
+            int maxConnections = 1;
+        } segmentedDownload;
+
+        // downloaded artifacts are stored by sha256 and served from disk on re-deploy. Disabled if nullptr
+        std::shared_ptr<ArtifactCache> artifactCache;
+
+        // deployments finished in background by handler. Disabled if nullptr
+        std::shared_ptr<AsyncActions> asyncActions;
+
+        // action feedback is delivered in background from durable journal. Disabled if nullptr
+        std::unique_ptr<FeedbackOutbox> feedbackOutbox;
+
+        // mTLS certificate is renewed in background before it expires. Disabled if nullptr
+        std::unique_ptr<CertificateRenewal> certRenewal;
+
+        // AuthErrorHandler is called by one thread at a time (polling, feedback sender or renewal thread)
+        std::mutex authErrorMutex;
+
+        bool serverCertificateVerify = true;
+
+        // keep-alive connections reused by all requests
+        std::shared_ptr<ConnectionPool> connectionPool = std::make_shared<ConnectionPool>();
+
+        // polling loop state, guarded by runMutex
+        std::mutex runMutex;
+        std::condition_variable runStateChanged;
+        bool running = false;
+        bool stopRequested = false;
+        // poll requested by pollNow() while loop is sleeping or polling
+        bool pollRequested = false;
+        // feedback of async action is queued while loop is sleeping
+        bool feedbackQueued = false;
+        std::thread::id runThreadId;
+        std::thread asyncThread;
+        std::exception_ptr asyncError;
+
+#ifndef _WIN32
+        // external pollNow() trigger, declared after runMutex so it is destroyed first
+        std::unique_ptr<PollTrigger> pollTrigger;
+#endif
+
+        // poll till stop is requested
+        void runLoop();
+
+        // mark loop as finished and wake up stop()
+        void setStopped();
+
+        bool isStopRequested();
+
+        // sleep which is interrupted by stop() and pollNow(). Queued feedback is sent meanwhile
+        void sleepUntil(PollSchedule::Clock::time_point deadline);
+
+        // single poll. Returns time till the next poll (ms)
+        int pollOnce();
 
         // starting hawkbit communication logic.
         //  returns execute time in ms
         void doPoll();
 
+        // wake up sleeping loop to send queued feedback
+        void onFeedbackQueued();
+
+        // send feedback queued by async actions. Feedback not sent by connection error stays in queue
+        void sendQueuedFeedback();
+
+        // pass error of communication with hawkBit to pollErrorHandler. Returns false if there is no handler
+        //  or error has other cause (then it stops the client)
+        bool reportPollError(std::exception_ptr);
+
+        // send action feedback to hawkBit and notify delivery listener of response (or pass it to outbox)
+        void postFeedback(uri::URI &actionURI, Response *, int actionId);
+
+        // single delivery attempt of feedback from outbox
+        void deliverFeedback(const FeedbackOutbox::Entry &);
+
+        // final feedback of action is waiting in outbox, so action should not be processed again
+        bool isFeedbackPending(uri::URI &actionURI);
+
         // call user-defined handler and send config data to hawkBit
         void followConfigData(uri::URI &);
 
+        // key and value of config data entry
+        using ConfigEntry = std::pair<const std::string *, const std::string *>;
+
+        // send config data entries with DDI mode (replace or merge)
+        void putConfigData(uri::URI &, const char *mode, const std::vector<ConfigEntry> &entries);
+
         // call user-defined handler to process cancelAction and send response to hawkBit
         void followCancelAction(uri::URI &);
 
         // call user-defined handler to process deploymentBase and send response to hawkBit
         void followDeploymentBase(uri::URI &);
 
-        // all requests should go via retryHandler
-        httplib::Result wrappedRequest(uri::URI, const std::function<httplib::Result(httplib::Client &)> &);
+        // request sent with default headers of credentials snapshot
+        using Request = std::function<httplib::Result(httplib::Client &, const httplib::Headers &)>;
+
+        // all requests should go via retryHandler. If unexpected code is received, Retry-After header
+        //  is stored to retryAfter
+        httplib::Result wrappedRequest(uri::URI, const Request &, const std::vector<int> &expectedCodes,
+                                       std::string &retryAfter);
 
-        httplib::Result retryHandler(uri::URI, const std::function<httplib::Result(httplib::Client &)> &);
+        // restores authorization on 401, at startup and on certificate renewal. Credentials set by handler are
+        //  applied when it returns. Thread-safe, returns false if none were set
+        bool callAuthErrorHandler();
+
+        // snapshot of current credentials, it stays valid while request uses it
+        std::shared_ptr<const Credentials> loadCredentials() const;
+
+        // apply updates to current credentials and publish result as one snapshot. Thread-safe
+        void updateCredentials(const std::vector<CredentialsUpdate> &);
+
+        httplib::Result authorizedRequest(uri::URI, const Request &, const std::vector<int> &expectedCodes,
+                                          std::string &retryAfter);
+
+        // repeats request failed by connection or temporary server error according to policy
+        httplib::Result retryHandler(uri::URI, const Request &, const RetryPolicy &,
+                                     const std::vector<int> &expectedCodes = {HTTP_OK});
+
+        // wait before retry. Returns false if client is stopped (or download is canceled) meanwhile
+        bool waitBeforeRetry(int ms, CancellationToken *cancellation = nullptr);
+
+        // download resource part [from, to] (to = -1 - till the end) and pass it to receiver.
+        //  If connection is lost download is resumed from the last received byte (Range + If-Range with validator).
+        //  If server sends whole resource again onRestart is called, when onRestart is not set
+        //  (or part of resource is requested) download fails.
+        //  Canceled download is aborted at once (connection is closed) with download_canceled.
+        void resumableDownload(uri::URI &, long long from, long long to, std::string &validator,
+                               const std::function<bool(const char *, size_t)> &receiver,
+                               const std::function<void()> &onRestart, CancellationToken *cancellation);
+
+        // download file from server (by segments if enabled)
+        void downloadFromServer(const DownloadRequest &, const std::string &path);
+
+        // download file by segments in parallel. Returns false if server doesn't support ranges
+        bool segmentedDownloadTo(const DownloadRequest &, const std::string &path);
+
+        // pass artifact from local cache to receiver (progress and verifier are fed as for network download).
+        //  Returns false if artifact is not cached
+        bool readFromCache(const DownloadRequest &, const std::function<bool(const char *, size_t)> &receiver);
 
         // creates httpClient with predefined params
-        httplib::Client newHttpClient(uri::URI &) const;
+        std::unique_ptr<httplib::Client> newHttpClient(uri::URI &, TLSContext &) const;
 
     public:
 
-        [[noreturn]] virtual void run() override;
+        void run() override;
+
+        void runAsync() override;
 
-        void downloadTo(uri::URI uri, const std::string &path) override;
+        void stop() override;
+
+        void pollNow() override;
+
+        TLSSessionStatistics getTLSSessionStatistics() override;
+
+        void downloadTo(const DownloadRequest &request, const std::string &path) override;
 
         std::string getBody(uri::URI uri) override;
 
-        void downloadWithReceiver(uri::URI uri, std::function<bool(const char *, size_t)> function) override;
+        void downloadWithReceiver(const DownloadRequest &request,
+                                  std::function<bool(const char *, size_t)> function) override;
 
         void setTLS(const std::string &crt, const std::string &key) override;
 
@@ -78,7 +261,11 @@ namespace ddi {
 
         void setGatewayToken(const std::string &string) override;
 
+        ~HawkbitCommunicationClient() override;
+
         friend class DefaultClientBuilderImpl;
+
+        friend class GatewayImpl;
     };
 
     class DefaultClientBuilderImpl : public DDIClientBuilder {
@@ -103,6 +290,31 @@ namespace ddi {
 
         bool verifyServerCertificate = true;
 
+        int connectionIdleTimeout = DEFAULT_CONNECTION_IDLE_TIMEOUT;
+
+        RetryPolicy pollRetryPolicy;
+        RetryPolicy feedbackRetryPolicy;
+        RetryPolicy downloadRetryPolicy;
+
+        ClientErrorHandler pollErrorHandler;
+
+        double pollingJitter = 0;
+        int initialSplay = 0;
+
+        long long downloadSegmentSize = 0;
+        int downloadMaxConnections = 1;
+
+        std::string pollTriggerSocket;
+
+        std::string artifactCacheDir;
+        long long artifactCacheMaxSize = 0;
+
+        bool asyncDeployment = false;
+
+        std::string feedbackOutboxDir;
+
+        double certRenewalFraction = 0;
+
         AuthorizeVariants authVariant = AuthorizeVariants::NOT_SET;
 
     public:
@@ -120,6 +332,33 @@ namespace ddi {
 
         DDIClientBuilder *notVerifyServerCertificate() override;
 
+        DDIClientBuilder *setConnectionIdleTimeout(int idleTimeout) override;
+
+        DDIClientBuilder *setDownloadResumeAttempts(int attempts) override;
+
+        DDIClientBuilder *setPollRetryPolicy(const RetryPolicy &) override;
+
+        DDIClientBuilder *setPollErrorHandler(ClientErrorHandler) override;
+
+        DDIClientBuilder *setFeedbackRetryPolicy(const RetryPolicy &) override;
+
+        DDIClientBuilder *setDownloadRetryPolicy(const RetryPolicy &) override;
+
+        DDIClientBuilder *setSegmentedDownload(long long segmentSize, int maxConnections) override;
+
+        DDIClientBuilder *setPollingJitter(double ratio) override;
+
+        DDIClientBuilder *setInitialSplay(int maxSplay) override;
+
+        DDIClientBuilder *setPollTriggerSocket(const std::string &path) override;
+
+        DDIClientBuilder *setArtifactCache(const std::string &dir, long long maxSize) override;
+
+        DDIClientBuilder *setAsyncDeployment() override;
+
+        DDIClientBuilder *setFeedbackOutbox(const std::string &dir) override;
+
+        DDIClientBuilder *setCertificateRenewal(double lifetimeFraction) override;
 
         DDIClientBuilder *setTLS(const std::string &crt, const std::string &key) override;
 
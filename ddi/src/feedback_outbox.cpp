@@ -0,0 +1,318 @@
+#include <fstream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <utility>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "feedback_outbox.hpp"
+#include "action_context_impl.hpp"
+#include "ddi/hawkbit_exceptions.hpp"
+#include "retry_policy.hpp"
+#include "utils.hpp"
+
+namespace ddi {
+
+    const char *FEEDBACK_JOURNAL = "feedback.journal";
+
+    // journal is compacted when it has more delivered records than this (and than pending ones)
+    const size_t FEEDBACK_JOURNAL_MAX_DEAD_RECORDS = 256;
+
+    // appended records are synced to disk together at most this time after the first of them
+    const std::chrono::milliseconds FEEDBACK_JOURNAL_SYNC_INTERVAL(50);
+
+    void syncDescriptor(int fd) {
+#ifdef _WIN32
+        _commit(fd);
+#else
+        fsync(fd);
+#endif
+    }
+
+    // record: "F <seq> <execution> <url> <body>" - feedback, "D <seq>" - feedback is delivered.
+    //  Body is serialized JSON, so it has no line breaks
+    void writeRecord(std::FILE *file, const FeedbackOutbox::Entry &entry) {
+        std::fprintf(file, "F %llu %d %s ", entry.seq, (int) entry.execution, entry.url.c_str());
+        std::fwrite(entry.body.data(), 1, entry.body.size(), file);
+        std::fputc('\n', file);
+    }
+
+    void closeFile(std::FILE *file) {
+        std::fclose(file);
+    }
+
+    FeedbackOutbox::FeedbackOutbox(const std::string &dir, const RetryPolicy &policy_, Sender sender_)
+            : policy(policy_), sender(std::move(sender_)) {
+        auto journalDir = dir;
+        if (!journalDir.empty() && journalDir.back() == '/') {
+            journalDir.pop_back();
+        }
+        createDirectory(journalDir);
+        journalPath = journalDir + "/" + FEEDBACK_JOURNAL;
+        load();
+        syncThread = std::thread(&FeedbackOutbox::runSync, this);
+    }
+
+    void FeedbackOutbox::start() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!thread.joinable()) {
+            thread = std::thread(&FeedbackOutbox::run, this);
+        }
+    }
+
+    FeedbackOutbox::~FeedbackOutbox() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopRequested = true;
+            changed.notify_all();
+        }
+        if (thread.joinable()) {
+            thread.join();
+        }
+        if (syncThread.joinable()) {
+            syncThread.join();
+        }
+
+        if (journal) {
+            std::fflush(journal.get());
+            syncDescriptor(fileno(journal.get()));
+        }
+    }
+
+    void FeedbackOutbox::push(const std::string &url, Response::Execution execution, const char *body, size_t length,
+                              std::shared_ptr<ResponseDeliveryListener> listener) {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto it = pending.begin(); it != pending.end();) {
+            if (it->url == url && it->execution == Response::PROCEEDING &&
+                !(sending && it == pending.begin())) {
+                markDone(it->seq);
+                it = pending.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        pending.push_back({nextSeq++, execution, url, std::string(body, length), std::move(listener)});
+        append(pending.back());
+        changed.notify_all();
+    }
+
+    bool FeedbackOutbox::hasPendingFinal(const std::string &url) {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const auto &entry: pending) {
+            if (entry.url == url && isFinalExecution(entry.execution)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void FeedbackOutbox::run() {
+        std::unique_lock<std::mutex> lock(mutex);
+        Backoff backoff(policy);
+        while (!stopRequested) {
+            if (pending.empty()) {
+                if (deadRecords > 0) {
+                    compact(lock);
+                }
+                changed.wait(lock, [this]() { return stopRequested || !pending.empty(); });
+                continue;
+            }
+            if (Clock::now() < nextAttempt) {
+                changed.wait_until(lock, nextAttempt, [this]() { return stopRequested; });
+                continue;
+            }
+            auto entry = pending.front();
+            sending = true;
+            lock.unlock();
+
+            bool done = false;
+            bool delivered = false;
+            try {
+                sender(entry);
+                done = delivered = true;
+            } catch (http_unexpected_code_exception &e) {
+                // server will not accept it later
+                done = !isRetryableCode(e.getCode());
+            } catch (std::exception &) {
+                // connection error, retried
+            }
+
+            lock.lock();
+            sending = false;
+            if (!done) {
+                nextAttempt = Clock::now() + std::chrono::milliseconds(
+                        backoff.canRetry() ? backoff.nextDelay() : policy.maxDelay);
+                continue;
+            }
+            pending.pop_front();
+            markDone(entry.seq);
+            backoff = Backoff(policy);
+            if (deadRecords > FEEDBACK_JOURNAL_MAX_DEAD_RECORDS && deadRecords > pending.size()) {
+                compact(lock);
+            }
+
+            if (entry.listener) {
+                lock.unlock();
+                if (delivered) {
+                    entry.listener->onSuccessfulDelivery();
+                } else {
+                    entry.listener->onError();
+                }
+                lock.lock();
+            }
+        }
+    }
+
+    void FeedbackOutbox::runSync() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (!stopRequested) {
+            if (!dirty) {
+                changed.wait(lock);
+                continue;
+            }
+            if (Clock::now() < syncDeadline) {
+                changed.wait_until(lock, syncDeadline);
+                continue;
+            }
+
+            // files are kept open while they are synced, even if compaction replaces them meanwhile
+            dirty = false;
+            auto files = {journal, replacedJournal};
+            lock.unlock();
+            for (const auto &file: files) {
+                if (file) {
+                    syncDescriptor(fileno(file.get()));
+                }
+            }
+            lock.lock();
+        }
+    }
+
+    void FeedbackOutbox::write(const std::function<void(std::FILE *)> &record) {
+        // flushed at once, so record survives crash of process. Sync thread makes it survive power loss
+        for (auto file: {journal.get(), replacedJournal.get()}) {
+            if (file != nullptr) {
+                record(file);
+                std::fflush(file);
+            }
+        }
+        if (!dirty) {
+            dirty = true;
+            syncDeadline = Clock::now() + FEEDBACK_JOURNAL_SYNC_INTERVAL;
+            changed.notify_all();
+        }
+    }
+
+    void FeedbackOutbox::append(const Entry &entry) {
+        write([&](std::FILE *file) { writeRecord(file, entry); });
+    }
+
+    void FeedbackOutbox::markDone(unsigned long long seq) {
+        deadRecords++;
+        // lost record only makes feedback to be sent once more
+        write([&](std::FILE *file) { std::fprintf(file, "D %llu\n", seq); });
+    }
+
+    void FeedbackOutbox::load() {
+        std::map<unsigned long long, Entry> entries;
+        std::ifstream file(journalPath);
+        std::string line;
+        while (std::getline(file, line)) {
+            if (file.eof()) {
+                // record without line break is torn by crash
+                break;
+            }
+            std::istringstream fields(line);
+            char type;
+            unsigned long long seq;
+            if (!(fields >> type >> seq)) {
+                continue;
+            }
+            if (seq >= nextSeq) {
+                nextSeq = seq + 1;
+            }
+            if (type == 'D') {
+                entries.erase(seq);
+                continue;
+            }
+
+            Entry entry;
+            int execution;
+            if (type != 'F' || !(fields >> execution >> entry.url) ||
+                execution < Response::CLOSED || execution > Response::RESUMED || fields.get() != ' ') {
+                continue;
+            }
+            std::getline(fields, entry.body);
+            entry.seq = seq;
+            entry.execution = (Response::Execution) execution;
+            entries[seq] = std::move(entry);
+        }
+
+        for (auto &entry: entries) {
+            pending.push_back(std::move(entry.second));
+        }
+
+        std::unique_lock<std::mutex> lock(mutex);
+        compact(lock);
+    }
+
+    void FeedbackOutbox::compact(std::unique_lock<std::mutex> &lock) {
+        // records are appended to current journal while snapshot of pending entries is written and synced
+        auto snapshot = pending;
+        auto snapshotSeq = nextSeq;
+        auto deadBefore = deadRecords;
+        lock.unlock();
+
+        auto tmpPath = journalPath + ".tmp";
+        auto file = std::fopen(tmpPath.c_str(), "wb");
+        if (file == nullptr) {
+            lock.lock();
+            return;
+        }
+        std::shared_ptr<std::FILE> tmp(file, closeFile);
+        for (const auto &entry: snapshot) {
+            writeRecord(tmp.get(), entry);
+        }
+        std::fflush(tmp.get());
+        syncDescriptor(fileno(tmp.get()));
+
+        lock.lock();
+        // catch up with changes made while snapshot was written
+        std::set<unsigned long long> alive;
+        for (const auto &entry: pending) {
+            alive.insert(entry.seq);
+            if (entry.seq >= snapshotSeq) {
+                writeRecord(tmp.get(), entry);
+            }
+        }
+        for (const auto &entry: snapshot) {
+            if (alive.count(entry.seq) == 0) {
+                std::fprintf(tmp.get(), "D %llu\n", entry.seq);
+            }
+        }
+        // till rename records go to both files, so each of them is complete
+        replacedJournal = std::move(journal);
+        journal = tmp;
+        // flushes caught up records and schedules their sync
+        write([](std::FILE *) {});
+        lock.unlock();
+
+        auto renamed = replaceFile(tmpPath, journalPath);
+
+        lock.lock();
+        if (renamed) {
+            deadRecords -= deadBefore;
+            replacedJournal.reset();
+        } else {
+            // the old journal is kept (open file cannot be renamed on Windows)
+            journal = std::move(replacedJournal);
+        }
+    }
+
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "ddi/ddi_client.hpp"
+#include "ddi/hawkbit_response.hpp"
+
+namespace ddi {
+
+    // Durable queue of action feedback. Feedback is appended to journal file and delivered in order by background
+    //  thread, so caller never waits for the network. Records are flushed to OS when appended and synced to disk
+    //  by sync thread in batches (within FEEDBACK_JOURNAL_SYNC_INTERVAL), delivered records are marked in journal
+    //  and dropped on compaction. Not delivered feedback is loaded from journal on construction and sent again
+    //  (delivery is at least once).
+    class FeedbackOutbox {
+    public:
+        struct Entry {
+            unsigned long long seq;
+            Response::Execution execution;
+            // feedback resource of action (scheme://authority/path)
+            std::string url;
+            // JSON document
+            std::string body;
+            // not stored in journal, so it is lost on restart
+            std::shared_ptr<ResponseDeliveryListener> listener;
+        };
+
+        // send entry, throws on failure. http_unexpected_code_exception with not retryable code drops entry,
+        //  other errors are retried
+        using Sender = std::function<void(const Entry &)>;
+
+        // journal is stored in dir. Delays between retries are taken from policy, when retries are exhausted
+        //  entry is retried every maxDelay ms
+        FeedbackOutbox(const std::string &dir, const RetryPolicy &policy, Sender sender);
+
+        // pending PROCEEDING feedback of the same action (url) is superseded by the new one
+        void push(const std::string &url, Response::Execution, const char *body, size_t length,
+                  std::shared_ptr<ResponseDeliveryListener>);
+
+        // final (CLOSED, CANCELED, REJECTED) feedback of action is not delivered yet
+        bool hasPendingFinal(const std::string &url);
+
+        // start delivery in background
+        void start();
+
+        ~FeedbackOutbox();
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        std::string journalPath;
+        RetryPolicy policy;
+        Sender sender;
+
+        std::mutex mutex;
+        std::condition_variable changed;
+        std::deque<Entry> pending;
+        // the first pending entry is being sent, it cannot be superseded
+        bool sending = false;
+        Clock::time_point nextAttempt;
+        bool stopRequested = false;
+
+        // closed when the last user (writer or sync thread) drops it
+        std::shared_ptr<std::FILE> journal;
+        // journal being replaced by compaction. Records are written to both till the new one is renamed
+        std::shared_ptr<std::FILE> replacedJournal;
+        // records appended after the last sync, they are synced at syncDeadline
+        bool dirty = false;
+        Clock::time_point syncDeadline;
+        // delivered or superseded records in journal
+        size_t deadRecords = 0;
+        unsigned long long nextSeq = 1;
+
+        std::thread thread;
+        std::thread syncThread;
+
+        void run();
+
+        void runSync();
+
+        // should be called under lock
+        void write(const std::function<void(std::FILE *)> &);
+
+        // should be called under lock
+        void append(const Entry &);
+
+        // should be called under lock
+        void markDone(unsigned long long seq);
+
+        void load();
+
+        // rewrite journal with pending entries only. Should be called under lock from sender thread (or constructor),
+        //  lock is released while new journal is written and renamed
+        void compact(std::unique_lock<std::mutex> &);
+    };
+
+}
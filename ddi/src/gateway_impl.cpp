@@ -0,0 +1,314 @@
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+#include "gateway_impl.hpp"
+#include "utils.hpp"
+
+namespace ddi {
+
+    std::unique_ptr<GatewayBuilder> GatewayBuilder::newInstance() {
+        return std::unique_ptr<GatewayBuilder>(new GatewayBuilderImpl());
+    }
+
+    void GatewayImpl::addController(const std::string &controllerId, std::shared_ptr<EventHandler> handler) {
+        auto client = std::unique_ptr<HawkbitCommunicationClient>(new HawkbitCommunicationClient());
+        client->credentials = std::make_shared<const Credentials>(Credentials{
+                uri::URI::fromString(hawkbitEndpointFrom(hawkbitEndpoint, controllerId, tenant)), defaultHeaders,
+                tlsContext});
+        client->defaultSleepTime = defaultSleepTime;
+        client->currentSleepTime = defaultSleepTime;
+        client->handler = std::move(handler);
+        client->serverCertificateVerify = serverCertificateVerify;
+        client->connectionPool = connectionPool;
+        // worker is not blocked by retries, failed poll is rescheduled with backoff instead
+        client->pollRetryPolicy = NO_RETRY_POLICY;
+        if (asyncDeployment) {
+            // queued feedback is sent by the next poll of controller
+            client->asyncActions = std::make_shared<AsyncActions>();
+            client->asyncActions->setWakeUp([this, controllerId]() {
+                pollNow(controllerId);
+            });
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (controllers.count(controllerId) != 0) {
+            throw client_initialize_error("controller " + controllerId + " is already added");
+        }
+        auto &controller = controllers[controllerId];
+        controller.client = std::move(client);
+        controller.failedPolls = Backoff(pollRetryPolicy);
+        scheduleAt(controllerId, controller, pollSchedule.first(Clock::now()));
+    }
+
+    void GatewayImpl::removeController(const std::string &controllerId) {
+        std::unique_ptr<HawkbitCommunicationClient> removed;
+        std::lock_guard<std::mutex> lock(mutex);
+        auto found = controllers.find(controllerId);
+        if (found == controllers.end()) {
+            return;
+        }
+        if (found->second.polling) {
+            // worker removes it when poll is finished
+            found->second.removed = true;
+            return;
+        }
+        // scheduled polls are skipped as there is no controller
+        removed = std::move(found->second.client);
+        controllers.erase(found);
+    }
+
+    void GatewayImpl::pollNow(const std::string &controllerId) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto found = controllers.find(controllerId);
+        if (found == controllers.end()) {
+            return;
+        }
+        if (found->second.polling) {
+            found->second.pollRequested = true;
+            return;
+        }
+        scheduleAt(controllerId, found->second, Clock::now());
+    }
+
+    void GatewayImpl::setClientStopped(HawkbitCommunicationClient &client, bool stopped) {
+        std::lock_guard<std::mutex> lock(client.runMutex);
+        client.stopRequested = stopped;
+        client.runStateChanged.notify_all();
+    }
+
+    void GatewayImpl::scheduleAt(const std::string &controllerId, Controller &controller, Clock::time_point deadline) {
+        // previous timer is outdated by generation, so re-arm costs the same as scheduling
+        controller.generation++;
+        controller.deadline = deadline;
+        schedule.schedule(deadline, {controllerId, controller.generation});
+        scheduleChanged.notify_one();
+    }
+
+    void GatewayImpl::work() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (!stopRequested) {
+            if (duePolls.empty()) {
+                schedule.advance(Clock::now(), duePolls);
+            }
+            if (duePolls.empty()) {
+                if (schedule.empty()) {
+                    scheduleChanged.wait(lock);
+                } else {
+                    scheduleChanged.wait_until(lock, schedule.nextDeadline());
+                }
+                continue;
+            }
+            auto next = std::move(duePolls.front());
+            duePolls.pop_front();
+
+            auto found = controllers.find(next.key);
+            if (found == controllers.end() || found->second.generation != next.generation) {
+                continue;
+            }
+            auto &controller = found->second;
+            controller.polling = true;
+            controller.pollRequested = false;
+            auto client = controller.client.get();
+            // poll triggered before its deadline starts new period
+            auto pollStart = Clock::now();
+            auto periodStart = pollStart < controller.deadline ? pollStart : controller.deadline;
+            lock.unlock();
+
+            int sleepTime;
+            bool failed = true;
+            try {
+                sleepTime = client->pollOnce();
+                failed = false;
+            } catch (std::exception &e) {
+                if (pollErrorHandler) {
+                    pollErrorHandler(next.key, e);
+                }
+                sleepTime = defaultSleepTime;
+            } catch (...) {
+                // worker must survive any error of controller, otherwise the whole process is terminated
+                if (pollErrorHandler) {
+                    pollErrorHandler(next.key, std::runtime_error("unknown error"));
+                }
+                sleepTime = defaultSleepTime;
+            }
+
+            lock.lock();
+            // controllers map is node based, reference is still valid
+            controller.polling = false;
+            if (controller.removed) {
+                auto removed = std::move(controller.client);
+                controllers.erase(found);
+                lock.unlock();
+                removed.reset();
+                lock.lock();
+                continue;
+            }
+            auto now = Clock::now();
+            auto deadline = controller.pollRequested || sleepTime <= 0 ? now
+                                                                       : pollSchedule.next(periodStart, sleepTime, now);
+            if (!failed) {
+                controller.failedPolls = Backoff(pollRetryPolicy);
+            } else {
+                auto failureDelay = controller.failedPolls.canRetry() ? controller.failedPolls.nextDelay()
+                                                                      : pollRetryPolicy.maxDelay;
+                deadline = std::max(deadline, now + std::chrono::milliseconds(failureDelay));
+            }
+            scheduleAt(next.key, controller, deadline);
+        }
+    }
+
+    void GatewayImpl::run() {
+        runAsync();
+
+        std::unique_lock<std::mutex> lock(mutex);
+        scheduleChanged.wait(lock, [this]() { return stopRequested; });
+        lock.unlock();
+
+        stop();
+    }
+
+    void GatewayImpl::runAsync() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (running) throw client_initialize_error("gateway is already running");
+        running = true;
+        stopRequested = false;
+        for (auto &controller: controllers) {
+            setClientStopped(*controller.second.client, false);
+        }
+        for (int i = 0; i < workersCount; i++) {
+            workers.emplace_back(&GatewayImpl::work, this);
+        }
+    }
+
+    void GatewayImpl::stop() {
+        std::vector<std::thread> stopped;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopRequested = true;
+            scheduleChanged.notify_all();
+            // interrupt waiting before retries
+            for (auto &controller: controllers) {
+                setClientStopped(*controller.second.client, true);
+            }
+            stopped.swap(workers);
+        }
+        for (auto &worker: stopped) {
+            worker.join();
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        running = false;
+    }
+
+    GatewayImpl::~GatewayImpl() {
+        stop();
+    }
+
+    GatewayBuilder *GatewayBuilderImpl::setHawkbitEndpoint(const std::string &endpoint, const std::string &tenant_) {
+        hawkbitEndpoint = endpoint;
+        tenant = tenant_;
+
+        return this;
+    }
+
+    GatewayBuilder *GatewayBuilderImpl::setGatewayToken(const std::string &token_) {
+        token = token_;
+
+        return this;
+    }
+
+    GatewayBuilder *GatewayBuilderImpl::setDefaultPollingTimeout(int pollingTimeout_) {
+        pollingTimeout = pollingTimeout_;
+
+        return this;
+    }
+
+    GatewayBuilder *GatewayBuilderImpl::addHeader(const std::string &k, const std::string &v) {
+        defaultHeaders.insert({k, v});
+
+        return this;
+    }
+
+    GatewayBuilder *GatewayBuilderImpl::notVerifyServerCertificate() {
+        verifyServerCertificate = false;
+
+        return this;
+    }
+
+    GatewayBuilder *GatewayBuilderImpl::setWorkersCount(int workers) {
+        workersCount = workers;
+
+        return this;
+    }
+
+    GatewayBuilder *GatewayBuilderImpl::setConnectionIdleTimeout(int idleTimeout) {
+        connectionIdleTimeout = idleTimeout;
+
+        return this;
+    }
+
+    GatewayBuilder *GatewayBuilderImpl::setPollingJitter(double ratio) {
+        pollingJitter = ratio;
+
+        return this;
+    }
+
+    GatewayBuilder *GatewayBuilderImpl::setInitialSplay(int maxSplay) {
+        initialSplay = maxSplay;
+
+        return this;
+    }
+
+    GatewayBuilder *GatewayBuilderImpl::setPollRetryPolicy(const RetryPolicy &policy) {
+        pollRetryPolicy = policy;
+
+        return this;
+    }
+
+    GatewayBuilder *GatewayBuilderImpl::setPollErrorHandler(PollErrorHandler handler) {
+        pollErrorHandler = std::move(handler);
+
+        return this;
+    }
+
+    GatewayBuilder *GatewayBuilderImpl::setAsyncDeployment() {
+        asyncDeployment = true;
+
+        return this;
+    }
+
+    std::unique_ptr<Gateway> GatewayBuilderImpl::build() {
+        if (hawkbitEndpoint.empty()) {
+            throw client_initialize_error("hawkBit endpoint is not set");
+        }
+        if (token.empty()) {
+            throw client_initialize_error("gateway token is not set");
+        }
+        if (workersCount < 1) {
+            throw client_initialize_error("workers count should be positive");
+        }
+
+        auto gateway = new GatewayImpl();
+        auto gatewayPtr = std::unique_ptr<Gateway>(gateway);
+
+        gateway->hawkbitEndpoint = hawkbitEndpoint;
+        gateway->tenant = tenant;
+        gateway->defaultHeaders = defaultHeaders;
+        gateway->defaultHeaders.insert({AUTHORIZATION_HEADER, formatAuthHeader(GATEWAY_TOKEN_HEADER, token)});
+        gateway->defaultSleepTime = pollingTimeout;
+        gateway->serverCertificateVerify = verifyServerCertificate;
+        gateway->workersCount = workersCount;
+        gateway->pollRetryPolicy = pollRetryPolicy;
+        gateway->pollErrorHandler = pollErrorHandler;
+        gateway->asyncDeployment = asyncDeployment;
+        gateway->pollSchedule.setJitter(pollingJitter);
+        gateway->pollSchedule.setSplay(initialSplay);
+        gateway->connectionPool->setIdleTimeout(connectionIdleTimeout);
+        // every worker can keep connection to hawkBit
+        gateway->connectionPool->setMaxIdlePerAuthority((size_t) workersCount);
+
+        return gatewayPtr;
+    }
+
+}
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ddi/gateway.hpp"
+#include "ddi_client_impl.hpp"
+#include "poll_schedule.hpp"
+#include "retry_policy.hpp"
+#include "timer_wheel.hpp"
+
+namespace ddi {
+
+    const int DEFAULT_GATEWAY_WORKERS = 4;
+
+    class GatewayImpl : public Gateway {
+        using Clock = TimerWheel::Clock;
+
+        struct Controller {
+            std::unique_ptr<HawkbitCommunicationClient> client;
+            // scheduled polls with other generation are outdated
+            unsigned long generation = 0;
+            // start of the current polling period
+            Clock::time_point deadline;
+            bool polling = false;
+            bool pollRequested = false;
+            bool removed = false;
+            // delay of the next poll after failed ones
+            Backoff failedPolls{NO_RETRY_POLICY};
+        };
+
+        std::string hawkbitEndpoint;
+        std::string tenant;
+        httplib::Headers defaultHeaders;
+        int defaultSleepTime = 30000;
+        bool serverCertificateVerify = true;
+        int workersCount = DEFAULT_GATEWAY_WORKERS;
+        RetryPolicy pollRetryPolicy;
+        PollErrorHandler pollErrorHandler;
+        PollSchedule pollSchedule;
+        bool asyncDeployment = false;
+
+        // shared by all controllers
+        std::shared_ptr<TLSContext> tlsContext = TLSContext::create();
+        std::shared_ptr<ConnectionPool> connectionPool = std::make_shared<ConnectionPool>();
+
+        std::mutex mutex;
+        std::condition_variable scheduleChanged;
+        std::map<std::string, Controller> controllers;
+        // timer key is controllerId
+        TimerWheel schedule;
+        // expired, but not taken by workers yet
+        std::deque<TimerWheel::Timer> duePolls;
+        bool running = false;
+        bool stopRequested = false;
+        std::vector<std::thread> workers;
+
+        // should be called under lock
+        void scheduleAt(const std::string &controllerId, Controller &, Clock::time_point);
+
+        void work();
+
+        // controller clients are not running, flag is used only to interrupt retries
+        void setClientStopped(HawkbitCommunicationClient &, bool stopped);
+
+    public:
+        void addController(const std::string &controllerId, std::shared_ptr<EventHandler> handler) override;
+
+        void removeController(const std::string &controllerId) override;
+
+        void pollNow(const std::string &controllerId) override;
+
+        void run() override;
+
+        void runAsync() override;
+
+        void stop() override;
+
+        ~GatewayImpl() override;
+
+        friend class GatewayBuilderImpl;
+    };
+
+    class GatewayBuilderImpl : public GatewayBuilder {
+        std::string hawkbitEndpoint;
+        std::string tenant = "default";
+        std::string token;
+        httplib::Headers defaultHeaders;
+        int pollingTimeout = 30000;
+        bool verifyServerCertificate = true;
+        int workersCount = DEFAULT_GATEWAY_WORKERS;
+        int connectionIdleTimeout = DEFAULT_CONNECTION_IDLE_TIMEOUT;
+        RetryPolicy pollRetryPolicy;
+        PollErrorHandler pollErrorHandler;
+        double pollingJitter = 0;
+        int initialSplay = 0;
+        bool asyncDeployment = false;
+
+    public:
+        GatewayBuilder *setHawkbitEndpoint(const std::string &endpoint, const std::string &tenant) override;
+
+        GatewayBuilder *setGatewayToken(const std::string &) override;
+
+        GatewayBuilder *setDefaultPollingTimeout(int pollingTimeout) override;
+
+        GatewayBuilder *addHeader(const std::string &, const std::string &) override;
+
+        GatewayBuilder *notVerifyServerCertificate() override;
+
+        GatewayBuilder *setWorkersCount(int workers) override;
+
+        GatewayBuilder *setConnectionIdleTimeout(int idleTimeout) override;
+
+        GatewayBuilder *setPollingJitter(double ratio) override;
+
+        GatewayBuilder *setInitialSplay(int maxSplay) override;
+
+        GatewayBuilder *setPollRetryPolicy(const RetryPolicy &) override;
+
+        GatewayBuilder *setPollErrorHandler(PollErrorHandler) override;
+
+        GatewayBuilder *setAsyncDeployment() override;
+
+        std::unique_ptr<Gateway> build() override;
+    };
+
+}
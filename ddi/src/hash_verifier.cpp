@@ -0,0 +1,77 @@
+#include <cctype>
+
+#include "hash_verifier.hpp"
+#include "ddi/hawkbit_exceptions.hpp"
+
+namespace ddi {
+
+    HashVerifier::HashVerifier(const Hashes &expected, int verify) {
+        if (verify & VERIFY_MD5) {
+            digests.push_back({VERIFY_MD5, EVP_md5(), EVP_MD_CTX_new(), expected.md5});
+        }
+        if (verify & VERIFY_SHA1) {
+            digests.push_back({VERIFY_SHA1, EVP_sha1(), EVP_MD_CTX_new(), expected.sha1});
+        }
+        if (verify & VERIFY_SHA256) {
+            digests.push_back({VERIFY_SHA256, EVP_sha256(), EVP_MD_CTX_new(), expected.sha256});
+        }
+        reset();
+    }
+
+    void HashVerifier::update(const char *data, size_t size) {
+        for (auto &digest: digests) {
+            EVP_DigestUpdate(digest.ctx, data, size);
+        }
+    }
+
+    void HashVerifier::reset() {
+        for (auto &digest: digests) {
+            EVP_DigestInit_ex(digest.ctx, digest.md, nullptr);
+        }
+    }
+
+    std::string toHex(const unsigned char *data, unsigned int size) {
+        static const char *alphabet = "0123456789abcdef";
+        std::string hex;
+        hex.reserve(size * 2);
+        for (unsigned int i = 0; i < size; i++) {
+            hex += alphabet[data[i] >> 4];
+            hex += alphabet[data[i] & 0x0f];
+        }
+        return hex;
+    }
+
+    bool equalsIgnoreCase(const std::string &a, const std::string &b) {
+        if (a.size() != b.size()) {
+            return false;
+        }
+        for (size_t i = 0; i < a.size(); i++) {
+            if (std::tolower((unsigned char) a[i]) != std::tolower((unsigned char) b[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void HashVerifier::verify() {
+        int failed = VERIFY_NONE;
+        for (auto &digest: digests) {
+            unsigned char value[EVP_MAX_MD_SIZE];
+            unsigned int size = 0;
+            EVP_DigestFinal_ex(digest.ctx, value, &size);
+            if (!equalsIgnoreCase(toHex(value, size), digest.expected)) {
+                failed |= digest.type;
+            }
+        }
+        if (failed != VERIFY_NONE) {
+            throw artifact_verification_error(failed);
+        }
+    }
+
+    HashVerifier::~HashVerifier() {
+        for (auto &digest: digests) {
+            EVP_MD_CTX_free(digest.ctx);
+        }
+    }
+
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <openssl/evp.h>
+
+#include "ddi/hawkbit_actions.hpp"
+
+namespace ddi {
+
+    // Calculates artifact hashes from received blocks and compares them with expected ones.
+    class HashVerifier {
+    public:
+        // verify - combination of HashVerify values
+        HashVerifier(const Hashes &expected, int verify);
+
+        HashVerifier(const HashVerifier &) = delete;
+
+        HashVerifier &operator=(const HashVerifier &) = delete;
+
+        void update(const char *data, size_t size);
+
+        // start from scratch (ex: server sent whole file again)
+        void reset();
+
+        // throws artifact_verification_error if at least one hash mismatched
+        void verify();
+
+        ~HashVerifier();
+
+    private:
+        struct Digest {
+            int type;
+            const EVP_MD *md;
+            EVP_MD_CTX *ctx;
+            std::string expected;
+        };
+
+        std::vector<Digest> digests;
+    };
+
+}
@@ -0,0 +1,41 @@
+#include "json_arena.hpp"
+
+namespace ddi {
+
+    const size_t JsonArena::DEFAULT_CAPACITY;
+
+    JsonArena::JsonArena(size_t capacity) : buffer(new char[capacity]),
+                                            allocator(buffer.get(), capacity, capacity) {}
+
+    void JsonArena::reset() {
+        allocator.Clear();
+        output.Clear();
+        path.clear();
+        parents.clear();
+    }
+
+    JsonArena::Allocator &JsonArena::getAllocator() {
+        return allocator;
+    }
+
+    const rapidjson::StringBuffer &JsonArena::serialize(const rapidjson::Value &value) {
+        output.Clear();
+        Writer writer(output, &allocator);
+        value.Accept(writer);
+        return output;
+    }
+
+    rapidjson::StringBuffer &JsonArena::newOutput() {
+        output.Clear();
+        return output;
+    }
+
+    std::string &JsonArena::pathBuffer() {
+        return path;
+    }
+
+    std::vector<size_t> &JsonArena::parentsBuffer() {
+        return parents;
+    }
+
+}
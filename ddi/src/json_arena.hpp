@@ -0,0 +1,59 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rapidjson/document.h"
+#include "rapidjson/reader.h"
+#include "rapidjson/stringbuffer.h"
+#include "rapidjson/writer.h"
+
+namespace ddi {
+
+    // Memory reused by JSON parsing and serialization of one client. Values, parser and writer stacks are
+    //  allocated from the initial block and the arena is reset before every poll, so they do not touch the heap
+    //  in steady-state polling (only overflow of the block is allocated and freed on reset).
+    // Parse results are not in the arena: parsed objects and their strings (ex. URI parts) are heap allocated.
+    // Not thread-safe: used only from the thread which polls the client.
+    class JsonArena {
+    public:
+        using Allocator = rapidjson::MemoryPoolAllocator<>;
+        using Reader = rapidjson::GenericReader<rapidjson::UTF8<>, rapidjson::UTF8<>, Allocator>;
+        using Writer = rapidjson::Writer<rapidjson::StringBuffer, rapidjson::UTF8<>, rapidjson::UTF8<>, Allocator>;
+
+        explicit JsonArena(size_t capacity = DEFAULT_CAPACITY);
+
+        JsonArena(const JsonArena &) = delete;
+
+        JsonArena &operator=(const JsonArena &) = delete;
+
+        // drop everything allocated since the previous reset. Values created before reset must not be used
+        void reset();
+
+        // allocator for documents, values and reader/writer stacks
+        Allocator &getAllocator();
+
+        // serialize value to reused buffer. Result is valid till the next serialize or reset
+        const rapidjson::StringBuffer &serialize(const rapidjson::Value &value);
+
+        // cleared reused buffer for streaming serialization with Writer (no document is built).
+        //  Content is valid till the next serialize or reset
+        rapidjson::StringBuffer &newOutput();
+
+        // buffers of JsonPathReader, their capacity is kept between parses
+        std::string &pathBuffer();
+
+        std::vector<size_t> &parentsBuffer();
+
+        static const size_t DEFAULT_CAPACITY = 4096;
+
+    private:
+        std::unique_ptr<char[]> buffer;
+        Allocator allocator;
+        rapidjson::StringBuffer output;
+        std::string path;
+        std::vector<size_t> parents;
+    };
+
+}
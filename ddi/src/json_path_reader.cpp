@@ -0,0 +1,112 @@
+#include "json_path_reader.hpp"
+#include "ddi/hawkbit_exceptions.hpp"
+
+namespace ddi {
+
+    void JsonPathReader::parse(const std::string &body, JsonArena &arena) {
+        path = &arena.pathBuffer();
+        parents = &arena.parentsBuffer();
+        path->clear();
+        parents->clear();
+
+        JsonArena::Reader reader(&arena.getAllocator());
+        rapidjson::StringStream stream(body.c_str());
+        if (reader.Parse<rapidjson::kParseDefaultFlags>(stream, *this).IsError()) {
+            throw unexpected_payload();
+        }
+    }
+
+    bool JsonPathReader::Null() {
+        return true;
+    }
+
+    bool JsonPathReader::Bool(bool) {
+        return true;
+    }
+
+    bool JsonPathReader::Int(int value) {
+        return onInteger(*path, value);
+    }
+
+    bool JsonPathReader::Uint(unsigned value) {
+        return onInteger(*path, value);
+    }
+
+    bool JsonPathReader::Int64(int64_t value) {
+        return onInteger(*path, value);
+    }
+
+    bool JsonPathReader::Uint64(uint64_t value) {
+        return value <= (uint64_t) INT64_MAX ? onInteger(*path, (int64_t) value) : true;
+    }
+
+    bool JsonPathReader::Double(double) {
+        return true;
+    }
+
+    bool JsonPathReader::RawNumber(const char *, rapidjson::SizeType, bool) {
+        return true;
+    }
+
+    bool JsonPathReader::String(const char *str, rapidjson::SizeType length, bool) {
+        return onString(*path, str, length);
+    }
+
+    bool JsonPathReader::StartObject() {
+        if (!onObjectStart(*path)) {
+            return false;
+        }
+        parents->push_back(path->size());
+        return true;
+    }
+
+    bool JsonPathReader::Key(const char *str, rapidjson::SizeType length, bool) {
+        // previous member of the same object is replaced
+        path->resize(parents->back());
+        *path += '/';
+        path->append(str, length);
+        return true;
+    }
+
+    bool JsonPathReader::EndObject(rapidjson::SizeType) {
+        path->resize(parents->back());
+        parents->pop_back();
+        return onObjectEnd(*path);
+    }
+
+    bool JsonPathReader::StartArray() {
+        if (!onArrayStart(*path)) {
+            return false;
+        }
+        parents->push_back(path->size());
+        *path += "/[]";
+        return true;
+    }
+
+    bool JsonPathReader::EndArray(rapidjson::SizeType) {
+        path->resize(parents->back());
+        parents->pop_back();
+        return true;
+    }
+
+    bool JsonPathReader::onString(const std::string &, const char *, size_t) {
+        return true;
+    }
+
+    bool JsonPathReader::onInteger(const std::string &, int64_t) {
+        return true;
+    }
+
+    bool JsonPathReader::onObjectStart(const std::string &) {
+        return true;
+    }
+
+    bool JsonPathReader::onObjectEnd(const std::string &) {
+        return true;
+    }
+
+    bool JsonPathReader::onArrayStart(const std::string &) {
+        return true;
+    }
+
+}
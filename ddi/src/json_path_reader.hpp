@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "json_arena.hpp"
+
+namespace ddi {
+
+    // Base of one-pass (SAX) parsers of hawkBit responses. No DOM is built: every value is passed to callbacks
+    //  with path of the value. Members are joined with '/', array items are marked with "[]",
+    //  ex: "/deployment/chunks/[]/artifacts/[]/hashes/sha1".
+    // Callbacks return false to reject payload.
+    class JsonPathReader {
+    public:
+        // throws unexpected_payload if body is not valid json or it was rejected by callbacks.
+        //  Parser memory is taken from arena
+        void parse(const std::string &body, JsonArena &arena);
+
+        // rapidjson::Reader handler
+        bool Null();
+
+        bool Bool(bool);
+
+        bool Int(int);
+
+        bool Uint(unsigned);
+
+        bool Int64(int64_t);
+
+        bool Uint64(uint64_t);
+
+        bool Double(double);
+
+        bool RawNumber(const char *str, rapidjson::SizeType length, bool copy);
+
+        bool String(const char *str, rapidjson::SizeType length, bool copy);
+
+        bool StartObject();
+
+        bool Key(const char *str, rapidjson::SizeType length, bool copy);
+
+        bool EndObject(rapidjson::SizeType);
+
+        bool StartArray();
+
+        bool EndArray(rapidjson::SizeType);
+
+        virtual ~JsonPathReader() = default;
+
+    protected:
+        virtual bool onString(const std::string &path, const char *str, size_t length);
+
+        virtual bool onInteger(const std::string &path, int64_t value);
+
+        virtual bool onObjectStart(const std::string &path);
+
+        virtual bool onObjectEnd(const std::string &path);
+
+        virtual bool onArrayStart(const std::string &path);
+
+    private:
+        // buffers owned by arena
+        std::string *path = nullptr;
+        // path length of every opened object/array
+        std::vector<size_t> *parents = nullptr;
+    };
+
+}
@@ -0,0 +1,38 @@
+#include <random>
+
+#include "poll_schedule.hpp"
+#include "utils.hpp"
+
+namespace ddi {
+
+    // random value in [from, to]. Generator is per thread, so schedule can be used by several workers
+    double uniformRandom(double from, double to) {
+        return std::uniform_real_distribution<double>(from, to)(threadRandom());
+    }
+
+    void PollSchedule::setJitter(double ratio) {
+        jitter = ratio < 0 ? 0 : (ratio > 1 ? 1 : ratio);
+    }
+
+    void PollSchedule::setSplay(int maxSplay) {
+        splay = maxSplay < 0 ? 0 : maxSplay;
+    }
+
+    PollSchedule::Clock::time_point PollSchedule::first(Clock::time_point now) const {
+        if (splay == 0) {
+            return now;
+        }
+        return now + std::chrono::milliseconds((long long) uniformRandom(0, splay));
+    }
+
+    PollSchedule::Clock::time_point PollSchedule::next(Clock::time_point previousDeadline, int interval,
+                                                       Clock::time_point now) const {
+        auto period = (double) interval;
+        if (jitter > 0) {
+            period *= uniformRandom(1 - jitter, 1 + jitter);
+        }
+        auto deadline = previousDeadline + std::chrono::milliseconds((long long) period);
+        return deadline < now ? now : deadline;
+    }
+
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <chrono>
+
+namespace ddi {
+
+    // Fixed-rate polling deadlines. Period is counted from the previous deadline (not from the end of poll),
+    //  so poll processing time does not shift the schedule. Random jitter and initial splay spread polls
+    //  of devices started at the same moment.
+    class PollSchedule {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        // every period is randomized in [interval * (1 - ratio), interval * (1 + ratio)]. ratio in [0, 1]
+        void setJitter(double ratio);
+
+        // first poll is delayed by random time in [0, maxSplay] ms
+        void setSplay(int maxSplay);
+
+        Clock::time_point first(Clock::time_point now) const;
+
+        // deadline of the next poll. Missed deadlines are not caught up: if next deadline is already passed,
+        //  poll is done now
+        Clock::time_point next(Clock::time_point previousDeadline, int interval, Clock::time_point now) const;
+
+    private:
+        double jitter = 0;
+        int splay = 0;
+    };
+
+}
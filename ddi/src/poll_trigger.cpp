@@ -0,0 +1,72 @@
+#ifndef _WIN32
+
+#include <cerrno>
+#include <cstring>
+#include <utility>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "poll_trigger.hpp"
+#include "ddi/hawkbit_exceptions.hpp"
+
+namespace ddi {
+
+    PollTrigger::PollTrigger(const std::string &path_, std::function<void()> onTrigger_)
+            : path(path_), onTrigger(std::move(onTrigger_)) {
+        sockaddr_un addr{};
+        if (path.size() >= sizeof(addr.sun_path)) {
+            throw client_initialize_error("poll trigger socket path is too long: " + path);
+        }
+        addr.sun_family = AF_UNIX;
+        strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+
+        sock = socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+        if (sock < 0) {
+            throw client_initialize_error(std::string("cannot create poll trigger socket: ") + strerror(errno));
+        }
+        // socket file left by previous run
+        unlink(path.c_str());
+        if (bind(sock, (sockaddr *) &addr, sizeof(addr)) != 0 || pipe(stopPipe) != 0) {
+            auto error = std::string("cannot open poll trigger socket ") + path + ": " + strerror(errno);
+            close(sock);
+            throw client_initialize_error(error);
+        }
+
+        listener = std::thread(&PollTrigger::listen, this);
+    }
+
+    void PollTrigger::listen() {
+        pollfd fds[2] = {{sock, POLLIN, 0}, {stopPipe[0], POLLIN, 0}};
+        char buf[256];
+        for (;;) {
+            if (::poll(fds, 2, -1) < 0) {
+                if (errno == EINTR) continue;
+                return;
+            }
+            if (fds[1].revents != 0) {
+                return;
+            }
+            if (fds[0].revents & POLLIN) {
+                // drain queued triggers
+                while (recv(sock, buf, sizeof(buf), MSG_DONTWAIT) >= 0);
+                onTrigger();
+            }
+        }
+    }
+
+    PollTrigger::~PollTrigger() {
+        char stopByte = 0;
+        while (write(stopPipe[1], &stopByte, 1) < 0 && errno == EINTR);
+        listener.join();
+        close(stopPipe[0]);
+        close(stopPipe[1]);
+        close(sock);
+        unlink(path.c_str());
+    }
+
+}
+
+#endif
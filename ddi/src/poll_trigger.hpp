@@ -0,0 +1,37 @@
+#pragma once
+
+#ifndef _WIN32
+
+#include <functional>
+#include <string>
+#include <thread>
+
+namespace ddi {
+
+    // Unix datagram socket which calls onTrigger when datagrams are received.
+    //  All datagrams queued at the moment are read at once, so burst of triggers causes single call.
+    class PollTrigger {
+    public:
+        // throws client_initialize_error if socket cannot be created
+        PollTrigger(const std::string &path, std::function<void()> onTrigger);
+
+        PollTrigger(const PollTrigger &) = delete;
+
+        PollTrigger &operator=(const PollTrigger &) = delete;
+
+        ~PollTrigger();
+
+    private:
+        std::string path;
+        std::function<void()> onTrigger;
+        int sock = -1;
+        // written on destruction to wake up listener
+        int stopPipe[2] = {-1, -1};
+        std::thread listener;
+
+        void listen();
+    };
+
+}
+
+#endif
@@ -0,0 +1,84 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+
+#include "retry_policy.hpp"
+#include "utils.hpp"
+
+namespace ddi {
+
+    const int HTTP_REQUEST_TIMEOUT = 408;
+    const int HTTP_TOO_MANY_REQUESTS = 429;
+    const int HTTP_INTERNAL_SERVER_ERROR = 500;
+    const int HTTP_BAD_GATEWAY = 502;
+    const int HTTP_SERVICE_UNAVAILABLE = 503;
+    const int HTTP_GATEWAY_TIMEOUT = 504;
+
+    bool isRetryableCode(int code) {
+        return code == HTTP_REQUEST_TIMEOUT || code == HTTP_TOO_MANY_REQUESTS || code == HTTP_INTERNAL_SERVER_ERROR
+               || code == HTTP_BAD_GATEWAY || code == HTTP_SERVICE_UNAVAILABLE || code == HTTP_GATEWAY_TIMEOUT;
+    }
+
+    // days since 1970-01-01 for proleptic Gregorian date
+    long long daysFromCivil(long long y, unsigned m, unsigned d) {
+        y -= m <= 2;
+        auto era = (y >= 0 ? y : y - 399) / 400;
+        auto yoe = (unsigned) (y - era * 400);
+        auto doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+        auto doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+        return era * 146097 + (long long) doe - 719468;
+    }
+
+    long long parseRetryAfter(const std::string &value) {
+        if (value.empty()) {
+            return -1;
+        }
+        if (std::all_of(value.begin(), value.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+            // longer delay is limited by policy anyway
+            return value.size() > 9 ? 999999999LL * 1000 : std::stoll(value) * 1000;
+        }
+
+        // IMF-fixdate, ex: Sun, 06 Nov 1994 08:49:37 GMT
+        char month[4] = {};
+        int day, year, hh, mm, ss;
+        if (sscanf(value.c_str(), "%*3s, %d %3s %d %d:%d:%d GMT", &day, month, &year, &hh, &mm, &ss) != 6) {
+            return -1;
+        }
+        const char *months[] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+        unsigned monthNum = 0;
+        while (monthNum < 12 && strcmp(months[monthNum], month) != 0) {
+            monthNum++;
+        }
+        if (monthNum == 12) {
+            return -1;
+        }
+        auto date = daysFromCivil(year, monthNum + 1, (unsigned) day) * 86400 + hh * 3600 + mm * 60 + ss;
+        auto now = std::chrono::duration_cast<std::chrono::seconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+        return date > now ? (date - now) * 1000 : 0;
+    }
+
+    Backoff::Backoff(const RetryPolicy &policy_) : policy(policy_), previousDelay(policy_.baseDelay) {}
+
+    bool Backoff::canRetry() const {
+        return retries < policy.maxRetries;
+    }
+
+    int Backoff::nextDelay(long long retryAfter) {
+        retries++;
+
+        auto upper = std::max<long long>(previousDelay * 3, policy.baseDelay);
+        auto delay = std::uniform_int_distribution<long long>(policy.baseDelay, upper)(threadRandom());
+        delay = std::min<long long>(delay, policy.maxDelay);
+        previousDelay = delay;
+
+        // server knows better when it is ready, but too long waiting is not allowed
+        if (retryAfter > delay) {
+            delay = std::min<long long>(retryAfter, policy.maxDelay);
+        }
+        return (int) delay;
+    }
+
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <string>
+
+#include "ddi/ddi_client.hpp"
+
+namespace ddi {
+
+    // request is not repeated
+    const RetryPolicy NO_RETRY_POLICY = {0, 0, 0};
+
+    // temporary server errors which are worth retrying
+    bool isRetryableCode(int code);
+
+    // parse Retry-After header value (delta-seconds or HTTP-date). Returns delay in ms, -1 if value is invalid
+    long long parseRetryAfter(const std::string &value);
+
+    // Delays between retries of one request
+    class Backoff {
+    public:
+        explicit Backoff(const RetryPolicy &policy);
+
+        bool canRetry() const;
+
+        // delay (ms) before the next retry. retryAfter - delay requested by server, -1 if not set
+        int nextDelay(long long retryAfter = -1);
+
+    private:
+        RetryPolicy policy;
+        int retries = 0;
+        long long previousDelay;
+    };
+
+}
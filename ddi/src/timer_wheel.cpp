@@ -0,0 +1,124 @@
+#include <utility>
+
+#include "timer_wheel.hpp"
+
+namespace ddi {
+
+    TimerWheel::TimerWheel(std::chrono::milliseconds tick_, Clock::time_point start_) : tick(tick_), start(start_) {}
+
+    void TimerWheel::schedule(Clock::time_point deadline, Timer timer) {
+        uint64_t deadlineTick = 0;
+        if (deadline > start) {
+            // round up, so timer is not expired before deadline
+            deadlineTick = (uint64_t) ((deadline - start + tick - Clock::duration(1)) / tick);
+        }
+        count++;
+        insert({deadlineTick, std::move(timer)});
+    }
+
+    void TimerWheel::insert(Entry &&entry) {
+        if (entry.tick <= currentTick) {
+            overdue.push_back(std::move(entry));
+            return;
+        }
+
+        auto delta = entry.tick - currentTick;
+        int level = 0;
+        while (level < LEVELS - 1 && delta >= ((uint64_t) 1 << (SLOT_BITS * (level + 1)))) {
+            level++;
+        }
+        auto slot = (entry.tick >> (SLOT_BITS * level)) & (SLOTS - 1);
+        slots[level][slot].push_back(std::move(entry));
+    }
+
+    void TimerWheel::advance(Clock::time_point now, std::deque<Timer> &expired) {
+        for (auto &entry: overdue) {
+            expired.push_back(std::move(entry.timer));
+        }
+        count -= overdue.size();
+        overdue.clear();
+
+        uint64_t targetTick = now > start ? (uint64_t) ((now - start) / tick) : 0;
+        while (currentTick < targetTick) {
+            // ticks without expiring or moved down timers are skipped, so long stall costs no more than busy wheel
+            auto eventTick = nextEventTick();
+            if (eventTick > targetTick) {
+                currentTick = targetTick;
+                break;
+            }
+            currentTick = eventTick;
+
+            // lower level wrapped: move timers of the next upper level slot down (from the highest level)
+            int wrapped = 0;
+            while (wrapped < LEVELS - 1
+                   && (currentTick & (((uint64_t) 1 << (SLOT_BITS * (wrapped + 1))) - 1)) == 0) {
+                wrapped++;
+            }
+            for (int level = wrapped; level > 0; level--) {
+                auto slot = (currentTick >> (SLOT_BITS * level)) & (SLOTS - 1);
+                auto entries = std::move(slots[level][slot]);
+                slots[level][slot].clear();
+                for (auto &entry: entries) {
+                    insert(std::move(entry));
+                }
+            }
+
+            auto &due = slots[0][currentTick & (SLOTS - 1)];
+            for (auto &entry: due) {
+                expired.push_back(std::move(entry.timer));
+            }
+            count -= due.size();
+            due.clear();
+
+            // timers moved down to the current tick
+            for (auto &entry: overdue) {
+                expired.push_back(std::move(entry.timer));
+            }
+            count -= overdue.size();
+            overdue.clear();
+        }
+    }
+
+    TimerWheel::Clock::time_point TimerWheel::nextDeadline() const {
+        if (count == 0) {
+            return Clock::time_point::max();
+        }
+        if (!overdue.empty()) {
+            return timeOf(currentTick);
+        }
+        return timeOf(nextEventTick());
+    }
+
+    uint64_t TimerWheel::nextEventTick() const {
+        uint64_t next = UINT64_MAX;
+        if (count == 0) {
+            return next;
+        }
+        // level N slot is handled at the first tick of its range (multiple of 256^N) after the current one,
+        //  timers inserted there are never further than one revolution of the level
+        for (int level = 0; level < LEVELS; level++) {
+            auto shift = SLOT_BITS * level;
+            auto block = currentTick >> shift;
+            for (uint64_t k = 1; k <= SLOTS; k++) {
+                auto t = (block + k) << shift;
+                if (t >= next) {
+                    break;
+                }
+                if (!slots[level][(block + k) & (SLOTS - 1)].empty()) {
+                    next = t;
+                    break;
+                }
+            }
+        }
+        return next;
+    }
+
+    bool TimerWheel::empty() const {
+        return count == 0;
+    }
+
+    TimerWheel::Clock::time_point TimerWheel::timeOf(uint64_t tick_) const {
+        return start + tick * (long long) tick_;
+    }
+
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace ddi {
+
+    // default timer wheel resolution (ms)
+    const int DEFAULT_TIMER_WHEEL_TICK = 10;
+
+    // Hierarchical timing wheel: 4 levels of 256 slots, level N slot covers 256^N ticks.
+    //  Timer is scheduled in O(1), timers of upper levels are moved down when lower level wraps.
+    //  Timers are not removed: owner marks outdated timers by generation and skips them on expiry.
+    class TimerWheel {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        struct Timer {
+            std::string key;
+            unsigned long generation;
+        };
+
+        explicit TimerWheel(std::chrono::milliseconds tick = std::chrono::milliseconds(DEFAULT_TIMER_WHEEL_TICK),
+                            Clock::time_point start = Clock::now());
+
+        // timer never expires before deadline, but can expire up to one tick later
+        void schedule(Clock::time_point deadline, Timer timer);
+
+        // move wheel to now and append expired timers
+        void advance(Clock::time_point now, std::deque<Timer> &expired);
+
+        // time when advance() should be called next time. Clock::time_point::max() if wheel is empty
+        Clock::time_point nextDeadline() const;
+
+        bool empty() const;
+
+    private:
+        static const int LEVELS = 4;
+        static const int SLOT_BITS = 8;
+        static const int SLOTS = 1 << SLOT_BITS;
+
+        struct Entry {
+            uint64_t tick;
+            Timer timer;
+        };
+
+        std::chrono::milliseconds tick;
+        Clock::time_point start;
+        uint64_t currentTick = 0;
+        size_t count = 0;
+
+        std::vector<Entry> slots[LEVELS][SLOTS];
+        // scheduled on already passed tick
+        std::vector<Entry> overdue;
+
+        void insert(Entry &&);
+
+        // first tick after current one where timers expire or are moved down, UINT64_MAX if wheel is empty
+        uint64_t nextEventTick() const;
+
+        Clock::time_point timeOf(uint64_t tick) const;
+    };
+
+}
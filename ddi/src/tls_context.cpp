@@ -0,0 +1,154 @@
+#include "tls_context.hpp"
+
+namespace ddi {
+
+    void freeSessionCache(void *, void *ptr, CRYPTO_EX_DATA *, int, long, void *) {
+        delete static_cast<TLSSessionCache *>(ptr);
+    }
+
+    // SSL_CTX -> TLSSessionCache
+    int sessionCacheIndex() {
+        static int index = SSL_CTX_get_ex_new_index(0, nullptr, nullptr, nullptr, freeSessionCache);
+        return index;
+    }
+
+    // SSL -> cache entry for its authority
+    int sessionEntryIndex() {
+        static int index = SSL_get_ex_new_index(0, nullptr, nullptr, nullptr, nullptr);
+        return index;
+    }
+
+    void TLSSessionCache::attachTo(SSL_CTX *ctx) {
+        SSL_CTX_set_ex_data(ctx, sessionCacheIndex(), new TLSSessionCache());
+        // do not use OpenSSL internal cache: it is not keyed by authority
+        SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+        SSL_CTX_sess_set_new_cb(ctx, TLSSessionCache::onNewSession);
+    }
+
+    TLSSessionCache *TLSSessionCache::from(SSL_CTX *ctx) {
+        if (ctx == nullptr) {
+            return nullptr;
+        }
+        return static_cast<TLSSessionCache *>(SSL_CTX_get_ex_data(ctx, sessionCacheIndex()));
+    }
+
+    void TLSSessionCache::offerSession(SSL *ssl, const std::string &authority) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto &entry = entries[authority];
+        SSL_set_ex_data(ssl, sessionEntryIndex(), &entry);
+        if (entry.session != nullptr && SSL_SESSION_is_resumable(entry.session)) {
+            SSL_set_session(ssl, entry.session);
+        }
+    }
+
+    void TLSSessionCache::onHandshakeDone(SSL *ssl) {
+        if (SSL_session_reused(ssl)) {
+            hits++;
+        } else {
+            misses++;
+        }
+    }
+
+    // with TLS 1.3 tickets come after handshake, so sessions are stored from callback
+    int TLSSessionCache::onNewSession(SSL *ssl, SSL_SESSION *session) {
+        auto cache = from(SSL_get_SSL_CTX(ssl));
+        auto entry = static_cast<Entry *>(SSL_get_ex_data(ssl, sessionEntryIndex()));
+        if (cache == nullptr || entry == nullptr) {
+            return 0;
+        }
+
+        SSL_SESSION *old;
+        {
+            std::lock_guard<std::mutex> lock(cache->mutex);
+            old = entry->session;
+            entry->session = session;
+        }
+        if (old != nullptr) {
+            SSL_SESSION_free(old);
+        }
+        // reference to session is kept by cache
+        return 1;
+    }
+
+    unsigned long TLSSessionCache::getHits() {
+        return hits;
+    }
+
+    unsigned long TLSSessionCache::getMisses() {
+        return misses;
+    }
+
+    TLSSessionCache::~TLSSessionCache() {
+        for (auto &entry: entries) {
+            if (entry.second.session != nullptr) {
+                SSL_SESSION_free(entry.second.session);
+            }
+        }
+    }
+
+    bool TLSContext::initContext() {
+        ctx = SSL_CTX_new(TLS_client_method());
+        if (ctx == nullptr) {
+            return false;
+        }
+        // trusted certs are loaded once per context (not per connection)
+        SSL_CTX_set_default_verify_paths(ctx);
+        TLSSessionCache::attachTo(ctx);
+        return true;
+    }
+
+    std::shared_ptr<TLSContext> TLSContext::create() {
+        auto tlsContext = std::shared_ptr<TLSContext>(new TLSContext());
+        tlsContext->initContext();
+
+        return tlsContext;
+    }
+
+    std::shared_ptr<TLSContext> TLSContext::fromKeyPair(const std::string &crt, const std::string &key) {
+        auto tlsContext = std::shared_ptr<TLSContext>(new TLSContext());
+        tlsContext->keyPairSet = true;
+
+        BIO *bio_crt = BIO_new_mem_buf(crt.data(), (int) crt.size());
+        tlsContext->certificate = PEM_read_bio_X509(bio_crt, nullptr, nullptr, nullptr);
+        BIO_free(bio_crt);
+
+        BIO *bio_key = BIO_new_mem_buf(key.data(), (int) key.size());
+        tlsContext->key = PEM_read_bio_PrivateKey(bio_key, nullptr, nullptr, nullptr);
+        BIO_free(bio_key);
+
+        if (tlsContext->certificate == nullptr || tlsContext->key == nullptr || !tlsContext->initContext()) {
+            return tlsContext;
+        }
+
+        if (SSL_CTX_use_certificate(tlsContext->ctx, tlsContext->certificate) != 1 ||
+            SSL_CTX_use_PrivateKey(tlsContext->ctx, tlsContext->key) != 1) {
+            SSL_CTX_free(tlsContext->ctx);
+            tlsContext->ctx = nullptr;
+        }
+
+        return tlsContext;
+    }
+
+    bool TLSContext::hasKeyPair() {
+        return keyPairSet;
+    }
+
+    SSL_CTX *TLSContext::getContext() {
+        return ctx;
+    }
+
+    TLSSessionCache *TLSContext::getSessionCache() {
+        return TLSSessionCache::from(ctx);
+    }
+
+    X509 *TLSContext::getCertificate() {
+        return certificate;
+    }
+
+    TLSContext::~TLSContext() {
+        if (ctx) SSL_CTX_free(ctx);
+        if (certificate) X509_free(certificate);
+        if (key) EVP_PKEY_free(key);
+    }
+
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "httplib.h"
+
+namespace ddi {
+
+    // Client-side TLS session cache keyed by authority (scheme://host:port).
+    //  Sessions (TLS 1.2 session ids or TLS 1.3 tickets) are stored when server sends them and offered
+    //  on next handshake to the same authority, so reconnects use abbreviated handshake.
+    //  Owned by the SSL_CTX it is attached to.
+    class TLSSessionCache {
+    public:
+        // set cached session for authority (if any). Called before handshake.
+        void offerSession(SSL *, const std::string &authority);
+
+        // update hit/miss counters. Called after successful handshake.
+        void onHandshakeDone(SSL *);
+
+        unsigned long getHits();
+
+        unsigned long getMisses();
+
+        static void attachTo(SSL_CTX *);
+
+        static TLSSessionCache *from(SSL_CTX *);
+
+        ~TLSSessionCache();
+
+    private:
+        struct Entry {
+            SSL_SESSION *session = nullptr;
+        };
+
+        std::mutex mutex;
+        // map nodes are never erased, so Entry pointers stored in SSL objects stay valid
+        std::map<std::string, Entry> entries;
+
+        std::atomic<unsigned long> hits{0};
+        std::atomic<unsigned long> misses{0};
+
+        static int onNewSession(SSL *, SSL_SESSION *);
+    };
+
+    // SSL_CTX shared by all connections (and mTLS keypair if it's used).
+    //  Built once when credentials are set and shared by all connections until credentials change.
+    class TLSContext {
+    public:
+        // context without client certificate (token auth)
+        static std::shared_ptr<TLSContext> create();
+
+        static std::shared_ptr<TLSContext> fromKeyPair(const std::string &crt, const std::string &key);
+
+        bool hasKeyPair();
+
+        // returns nullptr if keypair cannot be parsed (requests will fail with connection error)
+        SSL_CTX *getContext();
+
+        // returns nullptr if context is not created
+        TLSSessionCache *getSessionCache();
+
+        X509 *getCertificate();
+
+        TLSContext(const TLSContext &) = delete;
+
+        TLSContext &operator=(const TLSContext &) = delete;
+
+        ~TLSContext();
+
+    private:
+        TLSContext() = default;
+
+        // create ctx_ and apply common settings
+        bool initContext();
+
+        SSL_CTX *ctx = nullptr;
+        X509 *certificate = nullptr;
+        EVP_PKEY *key = nullptr;
+        bool keyPairSet = false;
+    };
+
+}
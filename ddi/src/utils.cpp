@@ -1,10 +1,23 @@
+#include <cerrno>
+#include <cstdio>
+#include <fstream>
+
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 #include "utils.hpp"
 #include "ddi/hawkbit_exceptions.hpp"
 
 namespace ddi {
-    uri::URI parseHrefObject(const rapidjson::Value &hrefObject) {
+    uri::URI parseHref(const char *href, size_t length) {
         try {
-            return uri::URI::fromString(hrefObject["href"].GetString());
+            return uri::URI::fromString(href, length);
         } catch (std::exception &) {
             throw unexpected_payload();
         }
@@ -17,4 +30,48 @@ namespace ddi {
                "/controller/v1/" +
                controllerId_;
     }
+
+    bool replaceFile(const std::string &from, const std::string &to) {
+#ifdef _WIN32
+        std::remove(to.c_str());
+#endif
+        return std::rename(from.c_str(), to.c_str()) == 0;
+    }
+
+    void createDirectory(const std::string &dir) {
+#ifdef _WIN32
+        _mkdir(dir.c_str());
+#else
+        mkdir(dir.c_str(), 0755);
+#endif
+    }
+
+    bool preallocateFile(const std::string &path, long long size) {
+#ifndef _WIN32
+        int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) {
+            return false;
+        }
+        int error = size > 0 ? posix_fallocate(fd, 0, (off_t) size) : 0;
+        if (error == EINVAL || error == EOPNOTSUPP) {
+            // file system cannot allocate blocks, only the size is set
+            error = ftruncate(fd, (off_t) size) == 0 ? 0 : errno;
+        }
+        close(fd);
+        return error == 0;
+#else
+        // sparse file: disk space is taken by writes
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (size > 0) {
+            file.seekp(size - 1);
+            file.put('\0');
+        }
+        return !file.bad();
+#endif
+    }
+
+    std::mt19937 &threadRandom() {
+        thread_local std::mt19937 generator{std::random_device{}()};
+        return generator;
+    }
 }
\ No newline at end of file
@@ -1,12 +1,28 @@
 #pragma once
 
-#include "rapidjson/document.h"
+#include <random>
+#include <string>
+
 #include "uriparse.hpp"
 
 
 namespace ddi {
 
-    uri::URI parseHrefObject(const rapidjson::Value &hrefObject);
+    // parse href of hawkBit link. Throws unexpected_payload if href is invalid
+    uri::URI parseHref(const char *href, size_t length);
 
     std::string hawkbitEndpointFrom(const std::string &endpoint, const std::string &controllerId_, const std::string &tenant_);
+
+    // rename with overwrite (on Windows rename fails if destination exists)
+    bool replaceFile(const std::string &from, const std::string &to);
+
+    // existing directory is not an error
+    void createDirectory(const std::string &dir);
+
+    // create file of size with disk space allocated (posix_fallocate), so out of space fails here and not in the
+    //  middle of writes. Best-effort where blocks cannot be allocated (Windows, some file systems): size is set only
+    bool preallocateFile(const std::string &path, long long size);
+
+    // random generator of the calling thread (seeded on first use), so no lock is needed for jitter and backoff
+    std::mt19937 &threadRandom();
 }
\ No newline at end of file
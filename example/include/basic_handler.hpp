@@ -51,19 +51,23 @@ public:
         builder->addDetail("Printed deployment base info");
         std::cout << " + CHUNKS:" << std::endl;
 
-        for (const auto &chunk: dp->getChunks()) {
-            std::cout << "  part: " << chunk->getPart() << std::endl;
-            std::cout << "  name: " << chunk->getName() << " version: " << chunk->getVersion() << std::endl;
+        for (size_t i = 0; i < dp->chunksCount(); i++) {
+            auto &chunk = dp->chunkAt(i);
+            std::cout << "  part: " << chunk.getPart() << std::endl;
+            std::cout << "  name: " << chunk.getName() << " version: " << chunk.getVersion() << std::endl;
             std::cout << "  + ARTIFACTS:" << std::endl;
-            for (const auto &artifact: chunk->getArtifacts()) {
-                std::cout << "   filename: " << artifact->getFilename() << " size: " << artifact->size() << std::endl;
-                std::cout << "   md5: " << artifact->getFileHashes().md5 << std::endl;
-                std::cout << "   sha1: " << artifact->getFileHashes().sha1 << std::endl;
-                std::cout << "   sha256: " << artifact->getFileHashes().sha256 << std::endl;
-                builder->addDetail(artifact->getFilename() + " described. Starting download ...");
-                std::cout << "  .. downloading " + artifact->getFilename() + "...";
-                artifact->downloadTo(artifact->getFilename());
-                builder->addDetail("Downloaded " + artifact->getFilename());
+            for (size_t j = 0; j < chunk.artifactsCount(); j++) {
+                auto &artifact = chunk.artifactAt(j);
+                const auto &filename = artifact.getFilenameRef();
+                const auto &hashes = artifact.getFileHashesRef();
+                std::cout << "   filename: " << filename << " size: " << artifact.size() << std::endl;
+                std::cout << "   md5: " << hashes.md5 << std::endl;
+                std::cout << "   sha1: " << hashes.sha1 << std::endl;
+                std::cout << "   sha256: " << hashes.sha256 << std::endl;
+                builder->addDetail(filename + " described. Starting download ...");
+                std::cout << "  .. downloading " + filename + "...";
+                artifact.downloadTo(filename);
+                builder->addDetail("Downloaded " + filename);
                 std::cout << "[OK]" << std::endl;
             }
             std::cout << " + ---------------------------" << std::endl;
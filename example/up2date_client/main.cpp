@@ -1,5 +1,7 @@
 #include "basic_handler.hpp"
 #include "ritms_dps.hpp"
+#include <atomic>
+#include <csignal>
 #include <exception>
 #include <thread>
 
@@ -39,6 +41,19 @@ public:
     }
 };
 
+#ifdef _WIN32
+// no sigwait on Windows. Signal handler is run there in its own thread, so it can wait in stop() till run returns
+std::atomic<Client *> runningClient{nullptr};
+
+void stopClient(int signal) {
+    std::cout << "signal " << signal << " received, stopping..." << std::endl;
+    auto client = runningClient.load();
+    if (client != nullptr) {
+        client->stop();
+    }
+}
+#endif
+
 int main() {
     std::cout << "up2date hawkBit-cpp client started..." << std::endl;
 
@@ -64,9 +79,55 @@ int main() {
     auto authErrorHandler = std::shared_ptr<AuthErrorHandler>(new DPSInfoReloadHandler(std::move(dpsClient)));
 
 
+#ifndef _WIN32
+    // SIGTERM/SIGINT are handled by signal thread only (mask is inherited by other threads).
+    //  SIGUSR1 wakes it up when polling loop is finished by error
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGTERM);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGUSR1);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+#endif
+
     auto builder = DDIClientBuilder::newInstance();
-    builder->setAuthErrorHandler(authErrorHandler)
+    auto client = builder->setAuthErrorHandler(authErrorHandler)
+        // provisioning is repeated in background when 70% of certificate lifetime passed
+        ->setCertificateRenewal(0.7)
         ->setEventHandler(std::shared_ptr<EventHandler>(new Handler()))
-        ->build()
-        ->run();
+        ->build();
+
+#ifndef _WIN32
+    std::thread signalThread([&]() {
+        int signal;
+        sigwait(&signals, &signal);
+        if (signal == SIGUSR1) {
+            return;
+        }
+        std::cout << "signal " << signal << " received, stopping..." << std::endl;
+        // current poll (and its feedback) is finished before run returns
+        client->stop();
+    });
+#else
+    runningClient = client.get();
+    std::signal(SIGTERM, stopClient);
+    std::signal(SIGINT, stopClient);
+#endif
+
+    int status = 0;
+    try {
+        client->run();
+    } catch (std::exception &e) {
+        std::cout << "client stopped by error: " << e.what() << std::endl;
+        status = 1;
+    }
+#ifndef _WIN32
+    pthread_kill(signalThread.native_handle(), SIGUSR1);
+    signalThread.join();
+#else
+    std::signal(SIGTERM, SIG_DFL);
+    std::signal(SIGINT, SIG_DFL);
+    runningClient = nullptr;
+#endif
+    return status;
 }
\ No newline at end of file
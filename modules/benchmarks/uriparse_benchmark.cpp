@@ -0,0 +1,84 @@
+// URI parsing: single-pass uri::URI::fromString against the std::regex split it replaced.
+//  deploymentBase has one download href per artifact, so time per deploymentBase is time per href * artifacts.
+#include <chrono>
+#include <iostream>
+#include <regex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "uriparse.hpp"
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    const int ITERATIONS = 200;
+
+    struct Parts {
+        std::string scheme;
+        std::string authority;
+        std::string path;
+        std::string query;
+        std::string fragment;
+    };
+
+    // parser before single-pass split (RFC 3986 appendix B regex)
+    Parts fromStringRegex(const std::string &uri) {
+        static const std::regex uriRegex(R"(^(([^:\/?#]+):)?(//([^\/?#]*))?([^?#]*)(\?([^#]*))?(#(.*))?)",
+                                         std::regex::extended);
+        std::smatch match;
+        if (!std::regex_match(uri, match, uriRegex)) {
+            throw std::runtime_error("Malformed url.");
+        }
+        if (!match[4].matched) {
+            throw std::runtime_error("No scheme or authority");
+        }
+        Parts parts;
+        parts.scheme = match[2];
+        parts.authority = match[4];
+        parts.path = match[5];
+        parts.query = match[7];
+        parts.fragment = match[9];
+        return parts;
+    }
+
+    // download hrefs of deploymentBase artifacts
+    std::vector<std::string> artifactHrefs(int artifacts) {
+        std::vector<std::string> hrefs;
+        for (int i = 0; i < artifacts; i++) {
+            hrefs.push_back("https://hawkbit.example.com/default/controller/v1/dev-01/softwaremodules/"
+                            + std::to_string(i / 50) + "/artifacts/artifact-" + std::to_string(i) + ".bin");
+        }
+        return hrefs;
+    }
+
+    template<typename Parse>
+    double usPerDeploymentBase(const std::vector<std::string> &hrefs, Parse parse) {
+        size_t parsed = 0;
+        auto begin = Clock::now();
+        for (int i = 0; i < ITERATIONS; i++) {
+            for (const auto &href: hrefs) {
+                parsed += parse(href);
+            }
+        }
+        auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - begin);
+        if (parsed == 0) {
+            throw std::runtime_error("nothing parsed");
+        }
+        return (double) elapsed.count() / 1000.0 / ITERATIONS;
+    }
+}
+
+int main() {
+    for (int artifacts: {50, 500}) {
+        auto hrefs = artifactHrefs(artifacts);
+        auto split = usPerDeploymentBase(hrefs, [](const std::string &href) {
+            return uri::URI::fromString(href).getPath().size();
+        });
+        auto regex = usPerDeploymentBase(hrefs, [](const std::string &href) {
+            return fromStringRegex(href).path.size();
+        });
+        std::cout << "artifacts=" << artifacts << " split=" << split << "us regex=" << regex << "us" << std::endl;
+    }
+    return 0;
+}
@@ -602,6 +602,10 @@ using SocketOptions = std::function<void(socket_t sock)>;
 
 void default_socket_options(socket_t sock);
 
+#ifdef CPPHTTPLIB_OPENSSL_SUPPORT
+using SSLHandshakeCallback = std::function<void(SSL *ssl)>;
+#endif
+
 class Server {
 public:
   using Handler = std::function<void(const Request &, Response &)>;
@@ -1180,6 +1184,10 @@ public:
 #ifdef CPPHTTPLIB_OPENSSL_SUPPORT
   explicit Client(const std::string &scheme_host_port,
                   X509 *client_cert, EVP_PKEY *client_key);
+
+  // Use already configured SSL_CTX (certificates, verify paths). Context is
+  // shared, client holds own reference on it.
+  explicit Client(const std::string &scheme_host_port, SSL_CTX *shared_ctx);
 #endif
 
   // HTTP only interface
@@ -1374,6 +1382,9 @@ public:
   long get_openssl_verify_result() const;
 
   SSL_CTX *ssl_context() const;
+
+  void set_handshake_callbacks(SSLHandshakeCallback before_handshake,
+                               SSLHandshakeCallback after_handshake);
 #endif
 
 private:
@@ -1423,6 +1434,8 @@ public:
   explicit SSLClient(const std::string &host, int port, X509 *client_cert,
                      EVP_PKEY *client_key);
 
+  explicit SSLClient(const std::string &host, int port, SSL_CTX *shared_ctx);
+
   ~SSLClient() override;
 
   bool is_valid() const override;
@@ -1433,6 +1446,11 @@ public:
 
   SSL_CTX *ssl_context() const;
 
+  // before_handshake is called when SSL object is created (ex: to offer cached
+  // session), after_handshake when handshake is successfully done
+  void set_handshake_callbacks(SSLHandshakeCallback before_handshake,
+                               SSLHandshakeCallback after_handshake);
+
 private:
   bool create_and_connect_socket(Socket &socket, Error &error) override;
   void shutdown_ssl(Socket &socket, bool shutdown_gracefully) override;
@@ -1456,6 +1474,11 @@ private:
   SSL_CTX *ctx_;
   std::mutex ctx_mutex_;
   std::once_flag initialize_cert_;
+  // ctx_ is configured by its owner, certs should not be loaded again
+  bool ctx_shared_ = false;
+
+  SSLHandshakeCallback before_handshake_;
+  SSLHandshakeCallback after_handshake_;
 
   std::vector<std::string> host_components_;
 
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <string>
 
 namespace uri {
@@ -30,6 +31,9 @@ namespace uri {
         std::string getFragment();
 
         static URI fromString(const std::string&);
+
+        // parse URI from not null-terminated string
+        static URI fromString(const char *str, size_t length);
     };
 
 }
\ No newline at end of file
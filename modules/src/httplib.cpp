@@ -261,14 +261,293 @@ void read_file(const std::string &path, std::string &out) {
 }
 
 std::string file_extension(const std::string &path) {
-  std::smatch m;
-  static auto re = std::regex("\\.([a-zA-Z0-9]+)$");
-  if (std::regex_search(path, m, re)) { return m[1].str(); }
-  return std::string();
+  // \.([a-zA-Z0-9]+)$
+  auto dot = path.rfind('.');
+  if (dot == std::string::npos || dot + 1 == path.size()) {
+    return std::string();
+  }
+  for (auto i = dot + 1; i < path.size(); i++) {
+    auto c = path[i];
+    if (!(('a' <= c && c <= 'z') || ('A' <= c && c <= 'Z') ||
+          ('0' <= c && c <= '9'))) {
+      return std::string();
+    }
+  }
+  return path.substr(dot + 1);
 }
 
 bool is_space_or_tab(char c) { return c == ' ' || c == '\t'; }
 
+bool is_digit(char c) { return c >= '0' && c <= '9'; }
+
+// \s of ECMAScript regex
+bool is_regex_space(char c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' ||
+         c == '\r';
+}
+
+bool is_line_break(char c) { return c == '\n' || c == '\r'; }
+
+bool match_case_ignore(const std::string &s, size_t pos, const char *literal) {
+  for (; *literal; literal++, pos++) {
+    if (pos >= s.size() ||
+        ::tolower(static_cast<unsigned char>(s[pos])) !=
+            ::tolower(static_cast<unsigned char>(*literal))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool is_all_regex_space(const std::string &s, size_t pos) {
+  for (; pos < s.size(); pos++) {
+    if (!is_regex_space(s[pos])) { return false; }
+  }
+  return true;
+}
+
+// ^Content-Disposition:\s*form-data;\s*name="(.*?)"(?:;\s*filename="(.*?)")?\s*$
+// (case insensitive)
+bool parse_content_disposition(const std::string &s, std::string &name,
+                               std::string &filename) {
+  static const char prefix[] = "content-disposition:";
+  if (!match_case_ignore(s, 0, prefix)) { return false; }
+  auto pos = sizeof(prefix) - 1;
+  while (pos < s.size() && is_regex_space(s[pos])) { pos++; }
+  if (!match_case_ignore(s, pos, "form-data;")) { return false; }
+  pos += 10;
+  while (pos < s.size() && is_regex_space(s[pos])) { pos++; }
+  if (!match_case_ignore(s, pos, "name=\"")) { return false; }
+  auto name_begin = pos + 6;
+
+  // the shortest quoted value which is followed by the rest of header
+  for (auto name_end = name_begin; name_end < s.size(); name_end++) {
+    if (is_line_break(s[name_end])) { return false; }
+    if (s[name_end] != '"') { continue; }
+
+    auto rest = name_end + 1;
+    if (rest < s.size() && s[rest] == ';') {
+      auto p = rest + 1;
+      while (p < s.size() && is_regex_space(s[p])) { p++; }
+      if (match_case_ignore(s, p, "filename=\"")) {
+        auto filename_begin = p + 10;
+        for (auto filename_end = filename_begin; filename_end < s.size();
+             filename_end++) {
+          if (is_line_break(s[filename_end])) { break; }
+          if (s[filename_end] == '"' &&
+              is_all_regex_space(s, filename_end + 1)) {
+            name = s.substr(name_begin, name_end - name_begin);
+            filename = s.substr(filename_begin, filename_end - filename_begin);
+            return true;
+          }
+        }
+      }
+    }
+    if (is_all_regex_space(s, rest)) {
+      name = s.substr(name_begin, name_end - name_begin);
+      filename.clear();
+      return true;
+    }
+  }
+  return false;
+}
+
+// bytes=(\d*-\d*(?:,\s*\d*-\d*)*)
+bool is_valid_range_header(const std::string &s) {
+  if (s.compare(0, 6, "bytes=") != 0) { return false; }
+  auto pos = size_t(6);
+  while (true) {
+    while (pos < s.size() && is_digit(s[pos])) { pos++; }
+    if (pos == s.size() || s[pos] != '-') { return false; }
+    pos++;
+    while (pos < s.size() && is_digit(s[pos])) { pos++; }
+    if (pos == s.size()) { return true; }
+    if (s[pos] != ',') { return false; }
+    pos++;
+    while (pos < s.size() && is_regex_space(s[pos])) { pos++; }
+  }
+}
+
+// key=value or key="value" pair of WWW-Authenticate header starting at pos
+//  (optionally preceded by comma). Returns end of pair or npos.
+size_t match_auth_param(const std::string &s, size_t pos, std::string &key,
+                        std::string &val) {
+  if (pos >= s.size() || is_line_break(s[pos])) { return std::string::npos; }
+  // the shortest key
+  auto eq = pos + 1;
+  while (eq < s.size() && s[eq] != '=') {
+    if (is_line_break(s[eq])) { return std::string::npos; }
+    eq++;
+  }
+  if (eq == s.size()) { return std::string::npos; }
+  key = s.substr(pos, eq - pos);
+
+  auto val_begin = eq + 1;
+  if (val_begin < s.size() && s[val_begin] == '"') {
+    for (auto p = val_begin + 1; p < s.size() && !is_line_break(s[p]); p++) {
+      if (s[p] == '"') {
+        val = s.substr(val_begin + 1, p - val_begin - 1);
+        return p + 1;
+      }
+    }
+  }
+  auto val_end = s.find(',', val_begin);
+  if (val_end == std::string::npos) { val_end = s.size(); }
+  val = s.substr(val_begin, val_end - val_begin);
+  return val_end;
+}
+
+// (?:(?:,\s*)?(.+?)=(?:"(.*?)"|([^,]*))) for every match
+void parse_auth_params(const std::string &s,
+                       std::map<std::string, std::string> &auth) {
+  std::string key;
+  std::string val;
+  size_t pos = 0;
+  while (pos < s.size()) {
+    auto end = std::string::npos;
+    if (s[pos] == ',') {
+      auto spaces = pos + 1;
+      while (spaces < s.size() && is_regex_space(s[spaces])) { spaces++; }
+      for (auto p = spaces; p > pos && end == std::string::npos; p--) {
+        end = match_auth_param(s, p, key, val);
+      }
+    }
+    if (end == std::string::npos) { end = match_auth_param(s, pos, key, val); }
+    if (end == std::string::npos) {
+      pos++;
+      continue;
+    }
+    auth[key] = val;
+    pos = end;
+  }
+}
+
+// (HTTP/1\.[01]) (\d{3})(?: (.*?))?\r\n
+bool parse_response_line(const char *s, std::string &version, int &status,
+                         std::string &reason) {
+  auto len = strlen(s);
+  if (len < 14 || strncmp(s, "HTTP/1.", 7) != 0 ||
+      (s[7] != '0' && s[7] != '1') || s[8] != ' ' || !is_digit(s[9]) ||
+      !is_digit(s[10]) || !is_digit(s[11]) || s[len - 2] != '\r' ||
+      s[len - 1] != '\n') {
+    return false;
+  }
+  std::string r;
+  if (len > 14) {
+    if (s[12] != ' ') { return false; }
+    for (auto p = s + 13; p < s + len - 2; p++) {
+      if (is_line_break(*p)) { return false; }
+    }
+    r.assign(s + 13, s + len - 2);
+  } else if (s[12] != '\r') {
+    return false;
+  }
+  version.assign(s, 8);
+  status = (s[9] - '0') * 100 + (s[10] - '0') * 10 + (s[11] - '0');
+  reason = std::move(r);
+  return true;
+}
+
+// (?::(\d+))? till the end
+bool match_port(const std::string &s, size_t pos, std::string &port) {
+  if (pos == s.size()) {
+    port.clear();
+    return true;
+  }
+  if (s[pos] != ':' || pos + 1 == s.size()) { return false; }
+  for (auto p = pos + 1; p < s.size(); p++) {
+    if (!is_digit(s[p])) { return false; }
+  }
+  port = s.substr(pos + 1);
+  return true;
+}
+
+// \[([\d:]+)\] or [^:/?#]+ starting at pos. Returns end of host or npos
+size_t match_host(const std::string &s, size_t pos, bool bracketed) {
+  auto p = pos;
+  if (bracketed) {
+    if (p == s.size() || s[p] != '[') { return std::string::npos; }
+    p++;
+    while (p < s.size() && (is_digit(s[p]) || s[p] == ':')) { p++; }
+    if (p == pos + 1 || p == s.size() || s[p] != ']') {
+      return std::string::npos;
+    }
+    return p + 1;
+  }
+  while (p < s.size() && s[p] != ':' && s[p] != '/' && s[p] != '?' &&
+         s[p] != '#') {
+    p++;
+  }
+  return p == pos ? std::string::npos : p;
+}
+
+// (?:([a-z]+)://)?(?:\[([\d:]+)\]|([^:/?#]+))(?::(\d+))?
+bool parse_scheme_host_port(const std::string &s, std::string &scheme,
+                            std::string &host, std::string &port) {
+  size_t pos = 0;
+  while (pos < s.size() && s[pos] >= 'a' && s[pos] <= 'z') { pos++; }
+  if (pos > 0 && s.compare(pos, 3, "://") == 0) {
+    scheme = s.substr(0, pos);
+    pos += 3;
+  } else {
+    scheme.clear();
+    pos = 0;
+  }
+
+  for (auto bracketed : {true, false}) {
+    auto host_end = match_host(s, pos, bracketed);
+    if (host_end != std::string::npos && match_port(s, host_end, port)) {
+      host = bracketed ? s.substr(pos + 1, host_end - pos - 2)
+                       : s.substr(pos, host_end - pos);
+      return true;
+    }
+  }
+  return false;
+}
+
+// (?:(https?):)?(?://(?:\[([\d:]+)\]|([^:/?#]+))(?::(\d+))?)?([^?#]*(?:\?[^#]*)?)(?:#.*)?
+bool parse_location(const std::string &s, std::string &scheme,
+                    std::string &host, std::string &port, std::string &path) {
+  auto fragment = s.find('#');
+  if (fragment != std::string::npos &&
+      s.find_first_of("\r\n", fragment) != std::string::npos) {
+    return false;
+  }
+  if (fragment == std::string::npos) { fragment = s.size(); }
+
+  size_t pos = 0;
+  scheme.clear();
+  if (s.compare(0, 6, "https:") == 0) {
+    scheme = "https";
+    pos = 6;
+  } else if (s.compare(0, 5, "http:") == 0) {
+    scheme = "http";
+    pos = 5;
+  }
+
+  host.clear();
+  port.clear();
+  if (s.compare(pos, 2, "//") == 0) {
+    for (auto bracketed : {true, false}) {
+      auto host_end = match_host(s, pos + 2, bracketed);
+      if (host_end == std::string::npos) { continue; }
+      host = bracketed ? s.substr(pos + 3, host_end - pos - 4)
+                       : s.substr(pos + 2, host_end - pos - 2);
+      pos = host_end;
+      if (pos + 1 < s.size() && s[pos] == ':' && is_digit(s[pos + 1])) {
+        auto port_end = pos + 1;
+        while (port_end < s.size() && is_digit(s[port_end])) { port_end++; }
+        port = s.substr(pos + 1, port_end - pos - 1);
+        pos = port_end;
+      }
+      break;
+    }
+  }
+
+  path = s.substr(pos, fragment - pos);
+  return true;
+}
+
 std::pair<size_t, size_t> trim(const char *b, const char *e, size_t left,
                                       size_t right) {
   while (b + left < e && is_space_or_tab(b[left])) {
@@ -1833,33 +2112,29 @@ bool parse_range_header(const std::string &s, Ranges &ranges) {
 #else
 bool parse_range_header(const std::string &s, Ranges &ranges) try {
 #endif
-  static auto re_first_range = std::regex(R"(bytes=(\d*-\d*(?:,\s*\d*-\d*)*))");
-  std::smatch m;
-  if (std::regex_match(s, m, re_first_range)) {
-    auto pos = static_cast<size_t>(m.position(1));
-    auto len = static_cast<size_t>(m.length(1));
+  if (is_valid_range_header(s)) {
+    auto pos = size_t(6);
+    auto len = s.size() - pos;
     bool all_valid_ranges = true;
     split(&s[pos], &s[pos + len], ',', [&](const char *b, const char *e) {
       if (!all_valid_ranges) return;
-      static auto re_another_range = std::regex(R"(\s*(\d*)-(\d*))");
-      std::cmatch cm;
-      if (std::regex_match(b, e, cm, re_another_range)) {
-        ssize_t first = -1;
-        if (!cm.str(1).empty()) {
-          first = static_cast<ssize_t>(std::stoll(cm.str(1)));
-        }
+      while (b != e && is_regex_space(*b)) { b++; }
+      auto dash = std::find(b, e, '-');
+      ssize_t first = -1;
+      if (b != dash) {
+        first = static_cast<ssize_t>(std::stoll(std::string(b, dash)));
+      }
 
-        ssize_t last = -1;
-        if (!cm.str(2).empty()) {
-          last = static_cast<ssize_t>(std::stoll(cm.str(2)));
-        }
+      ssize_t last = -1;
+      if (dash + 1 != e) {
+        last = static_cast<ssize_t>(std::stoll(std::string(dash + 1, e)));
+      }
 
-        if (first != -1 && last != -1 && first > last) {
-          all_valid_ranges = false;
-          return;
-        }
-        ranges.emplace_back(std::make_pair(first, last));
+      if (first != -1 && last != -1 && first > last) {
+        all_valid_ranges = false;
+        return;
       }
+      ranges.emplace_back(std::make_pair(first, last));
     });
     return all_valid_ranges;
   }
@@ -1881,10 +2156,6 @@ public:
   bool parse(const char *buf, size_t n, const ContentReceiver &content_callback,
              const MultipartContentHeader &header_callback) {
 
-    static const std::regex re_content_disposition(
-        "^Content-Disposition:\\s*form-data;\\s*name=\"(.*?)\"(?:;\\s*filename="
-        "\"(.*?)\")?\\s*$",
-        std::regex_constants::icase);
     static const std::string dash_ = "--";
     static const std::string crlf_ = "\r\n";
 
@@ -1925,11 +2196,7 @@ public:
           if (start_with_case_ignore(header, header_name)) {
             file_.content_type = trim_copy(header.substr(header_name.size()));
           } else {
-            std::smatch m;
-            if (std::regex_match(header, m, re_content_disposition)) {
-              file_.name = m[1];
-              file_.filename = m[2];
-            }
+            parse_content_disposition(header, file_.name, file_.filename);
           }
 
           buf_erase(pos + crlf_.size());
@@ -2416,7 +2683,6 @@ bool parse_www_authenticate(const Response &res,
                                    bool is_proxy) {
   auto auth_key = is_proxy ? "Proxy-Authenticate" : "WWW-Authenticate";
   if (res.has_header(auth_key)) {
-    static auto re = std::regex(R"~((?:(?:,\s*)?(.+?)=(?:"(.*?)"|([^,]*))))~");
     auto s = res.get_header_value(auth_key);
     auto pos = s.find(' ');
     if (pos != std::string::npos) {
@@ -2425,18 +2691,7 @@ bool parse_www_authenticate(const Response &res,
         return false;
       } else if (type == "Digest") {
         s = s.substr(pos + 1);
-        auto beg = std::sregex_iterator(s.begin(), s.end(), re);
-        for (auto i = beg; i != std::sregex_iterator(); ++i) {
-          auto m = *i;
-          auto key = s.substr(static_cast<size_t>(m.position(1)),
-                              static_cast<size_t>(m.length(1)));
-          auto val = m.length(2) > 0
-                         ? s.substr(static_cast<size_t>(m.position(2)),
-                                    static_cast<size_t>(m.length(2)))
-                         : s.substr(static_cast<size_t>(m.position(3)),
-                                    static_cast<size_t>(m.length(3)));
-          auth[key] = val;
-        }
+        parse_auth_params(s, auth);
         return true;
       }
     }
@@ -2511,8 +2766,13 @@ void hosted_at(const char *hostname, std::vector<std::string> &addrs) {
 
 std::string append_query_params(const char *path, const Params &params) {
   std::string path_with_query = path;
-  const static std::regex re("[^?]+\\?.*");
-  auto delm = std::regex_match(path, re) ? '&' : '?';
+  // path already has query: [^?]+\?.*
+  auto query = path_with_query.find('?');
+  auto delm = query != std::string::npos && query > 0 &&
+                      path_with_query.find_first_of("\r\n", query) ==
+                          std::string::npos
+                  ? '&'
+                  : '?';
   path_with_query += delm + detail::params_to_query_str(params);
   return path_with_query;
 }
@@ -3993,25 +4253,20 @@ bool ClientImpl::read_response_line(Stream &strm, const Request &req,
 
   if (!line_reader.getline()) { return false; }
 
-  const static std::regex re("(HTTP/1\\.[01]) (\\d{3})(?: (.*?))?\r\n");
-
-  std::cmatch m;
-  if (!std::regex_match(line_reader.ptr(), m, re)) {
+  if (!detail::parse_response_line(line_reader.ptr(), res.version, res.status,
+                                   res.reason)) {
     return req.method == "CONNECT";
   }
-  res.version = std::string(m[1]);
-  res.status = std::stoi(std::string(m[2]));
-  res.reason = std::string(m[3]);
 
   // Ignore '100 Continue'
   while (res.status == 100) {
     if (!line_reader.getline()) { return false; } // CRLF
     if (!line_reader.getline()) { return false; } // next response line
 
-    if (!std::regex_match(line_reader.ptr(), m, re)) { return false; }
-    res.version = std::string(m[1]);
-    res.status = std::stoi(std::string(m[2]));
-    res.reason = std::string(m[3]);
+    if (!detail::parse_response_line(line_reader.ptr(), res.version,
+                                     res.status, res.reason)) {
+      return false;
+    }
   }
 
   return true;
@@ -4188,20 +4443,17 @@ bool ClientImpl::redirect(Request &req, Response &res, Error &error) {
   auto location = detail::decode_url(res.get_header_value("location"), true);
   if (location.empty()) { return false; }
 
-  const static std::regex re(
-      R"((?:(https?):)?(?://(?:\[([\d:]+)\]|([^:/?#]+))(?::(\d+))?)?([^?#]*(?:\?[^#]*)?)(?:#.*)?)");
-
-  std::smatch m;
-  if (!std::regex_match(location, m, re)) { return false; }
+  std::string next_scheme;
+  std::string next_host;
+  std::string port_str;
+  std::string next_path;
+  if (!detail::parse_location(location, next_scheme, next_host, port_str,
+                              next_path)) {
+    return false;
+  }
 
   auto scheme = is_ssl() ? "https" : "http";
 
-  auto next_scheme = m[1].str();
-  auto next_host = m[2].str();
-  if (next_host.empty()) { next_host = m[3].str(); }
-  auto port_str = m[4].str();
-  auto next_path = m[5].str();
-
   auto next_port = port_;
   if (!port_str.empty()) {
     next_port = std::stoi(port_str);
@@ -5528,6 +5780,19 @@ SSLClient::SSLClient(const std::string &host, int port,
   }
 }
 
+SSLClient::SSLClient(const std::string &host, int port,
+                            SSL_CTX *shared_ctx)
+    : ClientImpl(host, port) {
+  ctx_ = shared_ctx;
+  ctx_shared_ = true;
+  if (ctx_) { SSL_CTX_up_ref(ctx_); }
+
+  detail::split(&host_[0], &host_[host_.size()], '.',
+                [&](const char *b, const char *e) {
+                  host_components_.emplace_back(std::string(b, e));
+                });
+}
+
 SSLClient::~SSLClient() {
   if (ctx_) { SSL_CTX_free(ctx_); }
   // Make sure to shut down SSL since shutdown_ssl will resolve to the
@@ -5557,6 +5822,12 @@ long SSLClient::get_openssl_verify_result() const {
 
 SSL_CTX *SSLClient::ssl_context() const { return ctx_; }
 
+void SSLClient::set_handshake_callbacks(SSLHandshakeCallback before_handshake,
+                                        SSLHandshakeCallback after_handshake) {
+  before_handshake_ = std::move(before_handshake);
+  after_handshake_ = std::move(after_handshake);
+}
+
 bool SSLClient::create_and_connect_socket(Socket &socket, Error &error) {
   return is_valid() && ClientImpl::create_and_connect_socket(socket, error);
 }
@@ -5622,6 +5893,8 @@ bool SSLClient::connect_with_proxy(Socket &socket, Response &res,
 bool SSLClient::load_certs() {
   bool ret = true;
 
+  if (ctx_shared_) { return ret; }
+
   std::call_once(initialize_cert_, [&]() {
     std::lock_guard<std::mutex> guard(ctx_mutex_);
     if (!ca_cert_file_path_.empty()) {
@@ -5688,10 +5961,13 @@ bool SSLClient::initialize_ssl(Socket &socket, Error &error) {
           X509_free(server_cert);
         }
 
+        if (after_handshake_) { after_handshake_(ssl); }
+
         return true;
       },
       [&](SSL *ssl) {
         SSL_set_tlsext_host_name(ssl, host_.c_str());
+        if (before_handshake_) { before_handshake_(ssl); }
         return true;
       });
 
@@ -5866,12 +6142,11 @@ Client::Client(const std::string &scheme_host_port)
 Client::Client(const std::string &scheme_host_port,
                       const std::string &client_cert_path,
                       const std::string &client_key_path) {
-  const static std::regex re(
-      R"((?:([a-z]+):\/\/)?(?:\[([\d:]+)\]|([^:/?#]+))(?::(\d+))?)");
-
-  std::smatch m;
-  if (std::regex_match(scheme_host_port, m, re)) {
-    auto scheme = m[1].str();
+  std::string scheme;
+  std::string host;
+  std::string port_str;
+  if (detail::parse_scheme_host_port(scheme_host_port, scheme, host,
+                                     port_str)) {
 
 #ifdef CPPHTTPLIB_OPENSSL_SUPPORT
     if (!scheme.empty() && (scheme != "http" && scheme != "https")) {
@@ -5887,10 +6162,6 @@ Client::Client(const std::string &scheme_host_port,
 
     auto is_ssl = scheme == "https";
 
-    auto host = m[2].str();
-    if (host.empty()) { host = m[3].str(); }
-
-    auto port_str = m[4].str();
     auto port = !port_str.empty() ? std::stoi(port_str) : (is_ssl ? 443 : 80);
 
     if (is_ssl) {
@@ -5910,27 +6181,39 @@ Client::Client(const std::string &scheme_host_port,
 }
 #ifdef CPPHTTPLIB_OPENSSL_SUPPORT
 Client::Client(const std::string &scheme_host_port, X509 *client_cert, EVP_PKEY *client_key){
-    const static std::regex re(
-            R"((?:([a-z]+):\/\/)?(?:\[([\d:]+)\]|([^:/?#]+))(?::(\d+))?)");
-
-    std::smatch m;
-    if (std::regex_match(scheme_host_port, m, re)) {
-        auto scheme = m[1].str();
+    std::string scheme;
+    std::string host;
+    std::string port_str;
+    if (detail::parse_scheme_host_port(scheme_host_port, scheme, host,
+                                       port_str)) {
         if (!scheme.empty() && scheme != "https") {
             std::string msg = "'" + scheme + "' scheme is not supported.";
             throw std::invalid_argument(msg);
         }
 
-        auto host = m[2].str();
-        if (host.empty()) { host = m[3].str(); }
-
-        auto port_str = m[4].str();
         auto port = !port_str.empty() ? std::stoi(port_str) : 443;
         cli_ = detail::make_unique<SSLClient>(host.c_str(), port,
                                               client_cert, client_key);
         is_ssl_ = true;
     }
 }
+
+Client::Client(const std::string &scheme_host_port, SSL_CTX *shared_ctx) {
+    std::string scheme;
+    std::string host;
+    std::string port_str;
+    if (detail::parse_scheme_host_port(scheme_host_port, scheme, host,
+                                       port_str)) {
+        if (!scheme.empty() && scheme != "https") {
+            std::string msg = "'" + scheme + "' scheme is not supported.";
+            throw std::invalid_argument(msg);
+        }
+
+        auto port = !port_str.empty() ? std::stoi(port_str) : 443;
+        cli_ = detail::make_unique<SSLClient>(host.c_str(), port, shared_ctx);
+        is_ssl_ = true;
+    }
+}
 #endif
 
 Client::Client(const std::string &host, int port)
@@ -6315,6 +6598,14 @@ SSL_CTX *Client::ssl_context() const {
   if (is_ssl_) { return static_cast<SSLClient &>(*cli_).ssl_context(); }
   return nullptr;
 }
+
+void Client::set_handshake_callbacks(SSLHandshakeCallback before_handshake,
+                                     SSLHandshakeCallback after_handshake) {
+  if (is_ssl_) {
+    static_cast<SSLClient &>(*cli_).set_handshake_callbacks(
+        std::move(before_handshake), std::move(after_handshake));
+  }
+}
 #endif
 
 } // namespace httplib
@@ -1,10 +1,14 @@
-#include <regex>
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
 
 #include "uriparse.hpp"
 
 namespace uri {
-    // URI find regex
-    const std::regex uri_regex(R"(^(([^:\/?#]+):)?(//([^\/?#]*))?([^?#]*)(\?([^#]*))?(#(.*))?)", std::regex::extended);
+    // first character from delimiters or end
+    const char *findFirstOf(const char *begin, const char *end, const char *delimiters) {
+        return std::find_if(begin, end, [delimiters](char c) { return c != '\0' && strchr(delimiters, c); });
+    }
 
     bool URI::hasPath() {
         return !path.empty();
@@ -39,38 +43,53 @@ namespace uri {
     }
 
     URI URI::fromString(const std::string& path) {
-        std::smatch url_match;
+        return fromString(path.data(), path.size());
+    }
 
-        if (!std::regex_match(path, url_match, uri_regex)) {
+    // Single pass split by RFC 3986 (appendix B):
+    //  ^(([^:/?#]+):)?(//([^/?#]*))?([^?#]*)(\?([^#]*))?(#(.*))?
+    //  as previous POSIX regex implementation, backslash is not allowed in scheme and authority
+    //  and fragment cannot contain NUL
+    URI URI::fromString(const char *str, size_t length) {
+        const char *end = str + length;
+        const char *fragmentBegin = std::find(str, end, '#');
+        if (fragmentBegin != end && std::find(fragmentBegin + 1, end, '\0') != end) {
             throw std::runtime_error("Malformed url.");
         }
 
-        if (!url_match[4].matched) {
-            throw std::runtime_error("No scheme or authority");
-        }
         URI retUri;
+        const char *pos = str;
         // get scheme
-        retUri.scheme = url_match[2];
-        // get authority
-        retUri.authority = url_match[4];
+        const char *schemeEnd = findFirstOf(pos, end, ":\\/?#");
+        if (schemeEnd != pos && schemeEnd != end && *schemeEnd == ':') {
+            retUri.scheme.assign(pos, schemeEnd);
+            pos = schemeEnd + 1;
+        }
 
-        if (!url_match[5].matched) {
-            return retUri;
+        if (end - pos < 2 || pos[0] != '/' || pos[1] != '/') {
+            throw std::runtime_error("No scheme or authority");
         }
+        // get authority
+        pos += 2;
+        const char *authorityEnd = findFirstOf(pos, end, "\\/?#");
+        retUri.authority.assign(pos, authorityEnd);
+        pos = authorityEnd;
+
         // get path
-        retUri.path = url_match[5];
+        const char *pathEnd = findFirstOf(pos, end, "?#");
+        retUri.path.assign(pos, pathEnd);
+        pos = pathEnd;
 
-        if (!url_match[7].matched) {
-            return retUri;
-        }
         // get query
-        retUri.query = url_match[7];
-
-        if (!url_match[9].matched) {
-            return retUri;
+        if (pos != end && *pos == '?') {
+            retUri.query.assign(pos + 1, fragmentBegin);
+            pos = fragmentBegin;
         }
+
         // get fragment
-        retUri.fragment = url_match[9];
+        if (pos != end) {
+            retUri.fragment.assign(pos + 1, end);
+        }
         return retUri;
     }
 
@@ -0,0 +1,320 @@
+// Compares regex-free scanners of httplib with std::regex they replaced. Every scanner should give the same
+//  result as its regex on edge cases and on random strings built from tokens significant for it.
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <random>
+#include <regex>
+#include <string>
+#include <vector>
+
+#include "httplib.h"
+
+namespace httplib {
+    namespace detail {
+        // internal to httplib.cpp
+        bool parse_content_disposition(const std::string &s, std::string &name, std::string &filename);
+
+        bool is_valid_range_header(const std::string &s);
+
+        void parse_auth_params(const std::string &s, std::map<std::string, std::string> &auth);
+
+        bool parse_response_line(const char *s, std::string &version, int &status, std::string &reason);
+
+        bool parse_scheme_host_port(const std::string &s, std::string &scheme, std::string &host, std::string &port);
+
+        bool parse_location(const std::string &s, std::string &scheme, std::string &host, std::string &port,
+                            std::string &path);
+
+        std::string file_extension(const std::string &path);
+    }
+
+    std::string append_query_params(const char *path, const Params &params);
+}
+
+namespace {
+    using namespace httplib::detail;
+
+    // result of scanner or regex serialized for comparison
+    using Scanner = std::function<std::string(const std::string &)>;
+
+    std::string join(std::initializer_list<std::string> parts) {
+        std::string result;
+        for (const auto &part: parts) {
+            result += "[" + part + "]";
+        }
+        return result;
+    }
+
+    std::string contentDispositionRegex(const std::string &s) {
+        static const std::regex re("^Content-Disposition:\\s*form-data;\\s*name=\"(.*?)\"(?:;\\s*filename="
+                                   "\"(.*?)\")?\\s*$", std::regex_constants::icase);
+        std::smatch m;
+        if (!std::regex_match(s, m, re)) {
+            return "no match";
+        }
+        return join({m[1], m[2]});
+    }
+
+    std::string contentDispositionScanner(const std::string &s) {
+        std::string name, filename;
+        if (!parse_content_disposition(s, name, filename)) {
+            return "no match";
+        }
+        return join({name, filename});
+    }
+
+    std::string rangeHeaderRegex(const std::string &s) {
+        static const std::regex re(R"(bytes=(\d*-\d*(?:,\s*\d*-\d*)*))");
+        return std::regex_match(s, re) ? "valid" : "invalid";
+    }
+
+    std::string rangeHeaderScanner(const std::string &s) {
+        return is_valid_range_header(s) ? "valid" : "invalid";
+    }
+
+    std::string authParamsRegex(const std::string &s) {
+        static const std::regex re(R"~((?:(?:,\s*)?(.+?)=(?:"(.*?)"|([^,]*))))~");
+        std::map<std::string, std::string> auth;
+        for (auto it = std::sregex_iterator(s.begin(), s.end(), re); it != std::sregex_iterator(); ++it) {
+            auto &m = *it;
+            auth[m[1]] = m.length(2) > 0 ? m[2] : m[3];
+        }
+        std::string result;
+        for (const auto &param: auth) {
+            result += join({param.first, param.second});
+        }
+        return result;
+    }
+
+    std::string authParamsScanner(const std::string &s) {
+        std::map<std::string, std::string> auth;
+        parse_auth_params(s, auth);
+        std::string result;
+        for (const auto &param: auth) {
+            result += join({param.first, param.second});
+        }
+        return result;
+    }
+
+    std::string responseLineRegex(const std::string &s) {
+        static const std::regex re("(HTTP/1\\.[01]) (\\d{3})(?: (.*?))?\r\n");
+        std::cmatch m;
+        if (!std::regex_match(s.c_str(), m, re)) {
+            return "no match";
+        }
+        return join({m[1], std::to_string(std::stoi(m[2])), m[3]});
+    }
+
+    std::string responseLineScanner(const std::string &s) {
+        std::string version, reason;
+        int status;
+        if (!parse_response_line(s.c_str(), version, status, reason)) {
+            return "no match";
+        }
+        return join({version, std::to_string(status), reason});
+    }
+
+    std::string schemeHostPortRegex(const std::string &s) {
+        static const std::regex re(R"((?:([a-z]+):\/\/)?(?:\[([\d:]+)\]|([^:/?#]+))(?::(\d+))?)");
+        std::smatch m;
+        if (!std::regex_match(s, m, re)) {
+            return "no match";
+        }
+        return join({m[1], m[2].length() > 0 ? m[2] : m[3], m[4]});
+    }
+
+    std::string schemeHostPortScanner(const std::string &s) {
+        std::string scheme, host, port;
+        if (!parse_scheme_host_port(s, scheme, host, port)) {
+            return "no match";
+        }
+        return join({scheme, host, port});
+    }
+
+    std::string locationRegex(const std::string &s) {
+        static const std::regex re(
+                R"((?:(https?):)?(?://(?:\[([\d:]+)\]|([^:/?#]+))(?::(\d+))?)?([^?#]*(?:\?[^#]*)?)(?:#.*)?)");
+        std::smatch m;
+        if (!std::regex_match(s, m, re)) {
+            return "no match";
+        }
+        return join({m[1], m[2].length() > 0 ? m[2] : m[3], m[4], m[5]});
+    }
+
+    std::string locationScanner(const std::string &s) {
+        std::string scheme, host, port, path;
+        if (!parse_location(s, scheme, host, port, path)) {
+            return "no match";
+        }
+        return join({scheme, host, port, path});
+    }
+
+    std::string queryParamsRegex(const std::string &s) {
+        static const std::regex re("[^?]+\\?.*");
+        return s + (std::regex_match(s, re) ? '&' : '?') + "k=v";
+    }
+
+    std::string queryParamsScanner(const std::string &s) {
+        return httplib::append_query_params(s.c_str(), {{"k", "v"}});
+    }
+
+    std::string fileExtensionRegex(const std::string &s) {
+        static const std::regex re("\\.([a-zA-Z0-9]+)$");
+        std::smatch m;
+        return std::regex_search(s, m, re) ? m[1].str() : std::string();
+    }
+
+    std::string fileExtensionScanner(const std::string &s) {
+        return file_extension(s);
+    }
+
+    struct Case {
+        const char *name;
+        Scanner regex;
+        Scanner scanner;
+        std::vector<std::string> corpus;
+        // random input is one of prefixes followed by tokens
+        std::vector<std::string> prefixes;
+        std::vector<std::string> tokens;
+    };
+
+    std::vector<Case> cases() {
+        return {
+                {"parse_content_disposition", contentDispositionRegex, contentDispositionScanner, {
+                        "Content-Disposition: form-data; name=\"file\"",
+                        "content-disposition:form-data;name=\"file\"; filename=\"a.txt\"",
+                        "CONTENT-DISPOSITION: FORM-DATA; NAME=\"f\"; FILENAME=\"A.TXT\"  \t",
+                        "Content-Disposition: form-data; name=\"\"; filename=\"\"",
+                        "Content-Disposition: form-data; name=\"a\"b\"",
+                        "Content-Disposition: form-data; name=\"a\"; filename=\"b\"c\"",
+                        "Content-Disposition: form-data; name=\"a\"; filename=\"b\\\"c.txt\"",
+                        "Content-Disposition: form-data; name=\"a\\\"; filename=\\\"b\"",
+                        "Content-Disposition: form-data; name=\"a\"; filename*=UTF-8''%e2%82%ac.txt",
+                        "Content-Disposition: form-data; name=\"a\"; filename=\"x\"; filename*=UTF-8''y",
+                        "Content-Disposition: form-data; name=\"a\";filename=\"b\"\r\n",
+                        "Content-Disposition: form-data; name=\"a\r\"",
+                        "Content-Disposition: form-data; name=\"a\"; filename=\"b\nc\"",
+                        "Content-Disposition: attachment; filename=\"a.txt\"",
+                        "Content-Disposition: form-data; name=a",
+                        "Content-Disposition: form-data; name=\"a\" ; filename=\"b\"",
+                        "Content-Disposition:",
+                        "",
+                }, {
+                        "", "Content-Disposition: form-data; ", "Content-Disposition: form-data; name=\"",
+                }, {
+                        "Content-Disposition:", "content-disposition:", " ", "\t", "form-data;", "FORM-DATA;",
+                        "name=\"", "filename=\"", "filename*=UTF-8''", "\"", ";", "a", "\\", "\r", "\n", ".txt",
+                }},
+                {"is_valid_range_header", rangeHeaderRegex, rangeHeaderScanner, {
+                        "bytes=0-99", "bytes=-500", "bytes=9500-", "bytes=0-0,-1", "bytes=500-600,601-999",
+                        "bytes=0-1, 2-3,\t4-5", "bytes=0-1,", "bytes=", "bytes=-", "bytes=1-2-3", "bytes=a-b",
+                        "bytes= 0-1", "Bytes=0-1", "bytes=0-1 ", "bytes=0-1,,2-3", "bytes=0-1,\r\n2-3", "",
+                }, {
+                        "", "bytes=", "bytes=0-",
+                }, {
+                        "0", "12", "-", "-", ",", ", ", ",\t", "\n", "x",
+                }},
+                {"parse_auth_params", authParamsRegex, authParamsScanner, {
+                        "realm=\"test\", nonce=\"abc\", qop=\"auth,auth-int\", algorithm=MD5",
+                        "realm=\"a=b\",nonce=x", "realm=", "realm=\"\"", "realm=\"unterminated, nonce=y",
+                        "=value", "a==b", ",, realm=x", "realm=x,,nonce=y", " realm = x ",
+                        "realm=\"a\r\nb\", nonce=y", "realm\r=x", "opaque=\"a\"b\"", "", "no params",
+                }, {
+                        "",
+                }, {
+                        "realm", "nonce", "=", "\"", ",", " ", "a b", "qop=\"auth,auth-int\"", "\r", "x",
+                }},
+                {"parse_response_line", responseLineRegex, responseLineScanner, {
+                        "HTTP/1.1 200 OK\r\n", "HTTP/1.0 404 Not Found\r\n", "HTTP/1.1 200\r\n",
+                        "HTTP/1.1 200 \r\n", "HTTP/1.1 200  OK \r\n", "HTTP/1.2 200 OK\r\n", "HTTP/2 200 OK\r\n",
+                        "HTTP/1.1 20 OK\r\n", "HTTP/1.1 2000 OK\r\n", "HTTP/1.1 200 OK\n", "HTTP/1.1 200 OK",
+                        "HTTP/1.1 200 O\rK\r\n", "HTTP/1.1 200 O\nK\r\n", "HTTP/1.1 200OK\r\n",
+                        "http/1.1 200 OK\r\n", "HTTP/1.1 abc OK\r\n", " HTTP/1.1 200 OK\r\n", "",
+                }, {
+                        "", "HTTP/1.1 200", "HTTP/1.0 404 Not", "HTTP/1.",
+                }, {
+                        "0", "1", " ", "200", "OK", "\r\n", "\r\n", "\r\n", "\r", "\n", "x",
+                }},
+                {"parse_scheme_host_port", schemeHostPortRegex, schemeHostPortScanner, {
+                        "http://example.com", "https://example.com:8443", "example.com:80", "localhost",
+                        "http://[::1]:8080", "[::1]", "[2001:db8::1]:443", "http://[fe80::1%eth0]:80",
+                        "[::1", "::1", "http://[]:80", "http://example.com:", "http://example.com:80a",
+                        "http://example.com/path", "HTTP://example.com", "ftp://example.com",
+                        "unix:///tmp/socket", "http://:80", "", "http://", "a:b:c",
+                }, {
+                        "", "http://", "https://[",
+                }, {
+                        "http", "://", "[", "]", "::1", ":", "80", "a.b", "/", "#", "x:", "9",
+                }},
+                {"parse_location", locationRegex, locationScanner, {
+                        "https://example.com/a?b=c#d", "http://example.com:8080/", "//example.com/x",
+                        "/relative/path?q=1", "relative", "http://[::1]:8080/x", "https://[2001:db8::1]/",
+                        "http://[::1/x", "http:/x", "https:", "http://example.com:port/x", "#only-fragment",
+                        "/a#b\r\nc", "/a\r\n#b", "/a?b\r\n", "?q", "ftp://example.com/", "", "http://",
+                        "http://example.com#", "//[::1]:",
+                }, {
+                        "", "https://", "//",
+                }, {
+                        "https:", "http:", "//", "[", "]", "::1", ":", "8080", "host", "/", "?q=1", "#f",
+                        "\r", "\n", "x",
+                }},
+                {"append_query_params", queryParamsRegex, queryParamsScanner, {
+                        "/path", "/path?a=b", "/path?", "?a=b", "/p?a\r\nb", "/p\r\n?a", "", "/a?b?c",
+                        "/p#f?x",
+                }, {
+                        "",
+                }, {
+                        "/p", "?", "&", "a=b", "#", "\r", "\n",
+                }},
+                {"file_extension", fileExtensionRegex, fileExtensionScanner, {
+                        "file.txt", "archive.tar.gz", "noext", ".hidden", "trailing.", "dir.d/file",
+                        "file.tx-t", "file.TXT", "file.mp4 ", "a.b.c1", "", ".", "file..txt", "path/.x/y.z9",
+                }, {
+                        "",
+                }, {
+                        "a", ".", "b", "1", "/", "-", " ", "tar", ".gz", "\n",
+                }},
+        };
+    }
+
+    int failures = 0;
+
+    void compare(const Case &c, const std::string &input) {
+        auto expected = c.regex(input);
+        auto actual = c.scanner(input);
+        if (expected != actual) {
+            failures++;
+            std::cerr << c.name << "(\"" << input << "\"): regex " << expected << ", scanner " << actual
+                      << std::endl;
+        }
+    }
+}
+
+int main() {
+    // fixed seed, so failure is reproducible
+    std::mt19937 random(20201);
+    for (const auto &c: cases()) {
+        for (const auto &input: c.corpus) {
+            compare(c, input);
+        }
+        std::uniform_int_distribution<size_t> prefix(0, c.prefixes.size() - 1);
+        std::uniform_int_distribution<size_t> tokenCount(0, 10);
+        std::uniform_int_distribution<size_t> token(0, c.tokens.size() - 1);
+        for (int i = 0; i < 20000; i++) {
+            auto input = c.prefixes[prefix(random)];
+            for (auto n = tokenCount(random); n > 0; n--) {
+                input += c.tokens[token(random)];
+            }
+            compare(c, input);
+        }
+    }
+
+    if (failures > 0) {
+        std::cerr << failures << " inputs differ" << std::endl;
+        return 1;
+    }
+    std::cout << "all scanners match regex" << std::endl;
+    return 0;
+}